@@ -2,6 +2,43 @@ include_guard()
 
 add_compile_definitions(PPC_PATH_TO_PROJECT="${CMAKE_CURRENT_SOURCE_DIR}")
 
+# Passed to modules/util/src/util.cpp only, so a new commit rebuilds one file instead of the tree
+set(PPC_GIT_REVISION "unknown")
+find_package(Git QUIET)
+if(GIT_FOUND)
+  execute_process(
+    COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+    WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+    OUTPUT_VARIABLE PPC_GIT_REVISION_OUTPUT
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    RESULT_VARIABLE PPC_GIT_REVISION_RESULT
+    ERROR_QUIET)
+  if(PPC_GIT_REVISION_RESULT EQUAL 0 AND PPC_GIT_REVISION_OUTPUT)
+    set(PPC_GIT_REVISION "${PPC_GIT_REVISION_OUTPUT}")
+  endif()
+  # Reconfigure when HEAD moves so the revision never goes stale
+  execute_process(
+    COMMAND ${GIT_EXECUTABLE} rev-parse --absolute-git-dir
+    WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+    OUTPUT_VARIABLE PPC_GIT_DIR
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET)
+  execute_process(
+    COMMAND ${GIT_EXECUTABLE} symbolic-ref -q HEAD
+    WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+    OUTPUT_VARIABLE PPC_GIT_HEAD_REF
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET)
+  foreach(git_file HEAD ${PPC_GIT_HEAD_REF})
+    if(PPC_GIT_DIR AND EXISTS "${PPC_GIT_DIR}/${git_file}")
+      set_property(
+        DIRECTORY
+        APPEND
+        PROPERTY CMAKE_CONFIGURE_DEPENDS "${PPC_GIT_DIR}/${git_file}")
+    endif()
+  endforeach()
+endif()
+
 macro(SUBDIRLIST result curdir)
   file(
     GLOB children
@@ -27,3 +64,17 @@ if(USE_PERF_TESTS)
   message(STATUS "Enable performance tests")
   add_compile_definitions(USE_PERF_TESTS)
 endif(USE_PERF_TESTS)
+
+option(ENABLE_ALLOC_TRACKING
+       "Count heap allocations of every task stage in performance results" OFF)
+if(ENABLE_ALLOC_TRACKING)
+  message(STATUS "Enable allocation tracking")
+  add_compile_definitions(PPC_ALLOC_TRACKING)
+endif(ENABLE_ALLOC_TRACKING)
+
+option(ENABLE_MPI_PROFILING
+       "Intercept MPI calls through PMPI and report them per task stage in performance results" OFF)
+if(ENABLE_MPI_PROFILING)
+  message(STATUS "Enable MPI profiling")
+  add_compile_definitions(PPC_MPI_PROFILING)
+endif(ENABLE_MPI_PROFILING)
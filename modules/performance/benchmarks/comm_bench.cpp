@@ -0,0 +1,73 @@
+#include <mpi.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "performance/include/comm_bench.hpp"
+#include "performance/include/performance.hpp"
+#include "util/include/util.hpp"
+
+namespace {
+
+// Print a result as "comm_bench:benchmark:bytes:quantity:value" and append it to the structured sink
+void ReportResult(const ppc::performance::CommBenchResult &result) {
+  const auto name = ppc::performance::kCommBenchmarkNames[static_cast<std::size_t>(result.benchmark)];
+  const std::string prefix = std::format("comm_bench:{}:{}:", name, result.bytes);
+  std::stringstream time_str;
+  std::stringstream bandwidth_str;
+  time_str << std::fixed << std::setprecision(10) << result.time_sec;
+  bandwidth_str << std::fixed << std::setprecision(4) << result.bandwidth_bytes_per_sec / 1e9;
+  std::cout << prefix << "time:" << time_str.str() << '\n';
+  std::cout << prefix << "bandwidth_gbs:" << bandwidth_str.str() << '\n';
+
+  const auto output_dir = ppc::util::GetPerfOutputDir();
+  if (!output_dir.empty()) {
+    ppc::performance::WritePerfRecord(ppc::performance::MakeCommBenchRecord(result), output_dir,
+                                      ppc::util::GetPerfOutputFormat(), "comm_bench");
+  }
+}
+
+int RunBenchmarks() {
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  const auto results = ppc::performance::RunCommBenchSuite(MPI_COMM_WORLD, ppc::util::GetCommBenchMaxBytes());
+  if (rank == 0) {
+    for (const auto &result : results) {
+      ReportResult(result);
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const int init_res = MPI_Init(&argc, &argv);
+  if (init_res != MPI_SUCCESS) {
+    std::cerr << std::format("[  ERROR  ] MPI_Init failed with code {}", init_res) << '\n';
+    MPI_Abort(MPI_COMM_WORLD, init_res);
+    return init_res;
+  }
+
+  int status = EXIT_SUCCESS;
+  try {
+    status = RunBenchmarks();
+  } catch (const std::exception &e) {
+    std::cerr << std::format("[  ERROR  ] Communication benchmark failed: {}", e.what()) << '\n';
+    MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+    return EXIT_FAILURE;
+  }
+
+  const int finalize_res = MPI_Finalize();
+  if (finalize_res != MPI_SUCCESS) {
+    std::cerr << std::format("[  ERROR  ] MPI_Finalize failed with code {}", finalize_res) << '\n';
+    return finalize_res;
+  }
+  return status;
+}
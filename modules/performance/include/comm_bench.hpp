@@ -0,0 +1,69 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string_view>
+#include <vector>
+
+namespace ppc::performance {
+
+/// @brief Communication patterns measured by the MPI micro-benchmark.
+enum class CommBenchmark : uint8_t {
+  /// Round trip between ranks 0 and 1; the reported time is half of the round trip
+  kPingPong,
+  kBcast,
+  kScatterv,
+  kGatherv,
+  kAllreduce,
+  kAllgatherv,
+  /// Every rank sends to its right neighbour and receives from its left one
+  kSendrecv,
+  /// Pairwise exchange along every dimension of the largest hypercube that fits into the communicator
+  kHypercube,
+};
+
+inline constexpr std::size_t kNumCommBenchmarks = 8;
+
+/// @brief Names of the benchmarks in the output, indexed by CommBenchmark.
+inline constexpr std::array<std::string_view, kNumCommBenchmarks> kCommBenchmarkNames = {
+    "ping_pong", "bcast", "scatterv", "gatherv", "allreduce", "allgatherv", "sendrecv", "hypercube"};
+
+/// @brief Measured cost of one benchmark at one message size.
+struct CommBenchResult {
+  CommBenchmark benchmark = CommBenchmark::kPingPong;
+  /// @brief Message size in bytes; for Scatterv, Gatherv and Allgatherv the size of the whole distributed buffer.
+  std::size_t bytes = 0;
+  int processes = 1;
+  uint64_t iterations = 0;
+  /// @brief Time of one operation in seconds, the maximum over ranks.
+  double time_sec = 0.0;
+  /// @brief Bytes of the message per second of time_sec (for the hypercube, summed over its dimensions).
+  double bandwidth_bytes_per_sec = 0.0;
+};
+
+/// @brief Number of timed repetitions of one operation: enough to move about 256 MB, at least 2 and at most 1000.
+uint64_t CommBenchIterations(std::size_t bytes);
+
+/// @brief Message sizes of the suite: powers of two from 1 byte up to max_bytes rounded down to a power of two.
+/// @return Ascending sizes; empty if max_bytes is 0.
+std::vector<std::size_t> CommBenchSizes(std::size_t max_bytes);
+
+/// @brief Returns false for point-to-point patterns that need more than one process.
+bool IsCommBenchmarkApplicable(CommBenchmark benchmark, int processes);
+
+/// @brief Measures one benchmark at one message size; must be called by every rank of the communicator.
+/// @return The result on every rank.
+CommBenchResult RunCommBenchmark(CommBenchmark benchmark, std::size_t bytes, MPI_Comm comm);
+
+/// @brief Measures every applicable benchmark at every size of CommBenchSizes(max_bytes).
+std::vector<CommBenchResult> RunCommBenchSuite(MPI_Comm comm, std::size_t max_bytes);
+
+/// @brief Builds the structured record of one benchmark result.
+/// @return Flat record with the benchmark, size, process count, timing, bandwidth, hostname and git revision.
+nlohmann::ordered_json MakeCommBenchRecord(const CommBenchResult &result);
+
+}  // namespace ppc::performance
@@ -1,15 +1,31 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <optional>
+#include <ranges>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "performance/include/roofline.hpp"
 #include "task/include/task.hpp"
+#include "util/include/alloc_tracker.hpp"
+#include "util/include/mpi_profiler.hpp"
+#include "util/include/node_shared.hpp"
+#include "util/include/trace.hpp"
 #include "util/include/util.hpp"
 
 namespace ppc::performance {
@@ -21,24 +37,325 @@ inline double DefaultTimer() {
 struct PerfAttr {
   /// @brief Number of times the task is run for performance evaluation.
   uint64_t num_running = 5;
+  /// @brief Number of untimed iterations executed before the measured ones.
+  uint64_t num_warmup = 0;
+  /// @brief Keep measuring until the confidence interval is tight or the time budget runs out.
+  bool adaptive = false;
+  /// @brief Target relative half-width of the median confidence interval in adaptive mode.
+  double target_relative_ci = 0.05;
+  /// @brief Time budget in seconds for the measured iterations in adaptive mode.
+  double time_budget_sec = 5.0;
+  /// @brief Upper bound on the number of measured iterations in adaptive mode.
+  uint64_t max_running = 1000;
+  /// @brief Confidence level of the bootstrap interval for the median.
+  double confidence_level = 0.95;
+  /// @brief Number of bootstrap resamples used to estimate the confidence interval.
+  uint64_t bootstrap_resamples = 1000;
+  /// @brief Additionally measure num_running iterations that each start with evicted caches.
+  bool cold_cache = false;
+  /// @brief Size of the buffer touched to evict caches; 0 means twice the detected last-level cache.
+  std::size_t cache_flush_bytes = 0;
+  /// @brief In task-run mode, restore the state saved after preprocessing before every Run() call.
+  /// @details The restore is not timed, so every iteration measures Run() on the same starting state.
+  bool restore_run_state = true;
+  /// @brief Count hardware events (cycles, instructions, cache and branch misses) of the measured iterations.
+  bool hardware_counters = false;
+  /// @brief Problem size reported in structured results; 0 means estimate it from the task input.
+  uint64_t input_size = 0;
+  /// @brief Bytes moved from and to memory by one Run() call over all ranks; enables throughput reporting.
+  uint64_t bytes_moved = 0;
+  /// @brief Floating-point operations of one Run() call over all ranks; enables throughput reporting.
+  uint64_t flops = 0;
   /// @brief Timer function returning current time in seconds.
   /// @cond
   std::function<double()> current_timer = DefaultTimer;
   /// @endcond
+  /// @brief Synchronizes all ranks before every measured iteration; empty for single-process runs.
+  /// @cond
+  std::function<void()> barrier;
+  /// @endcond
+  /// @brief Gathers an equally sized vector from every rank and returns their rank-ordered
+  ///        concatenation on all ranks; empty for single-process runs.
+  /// @cond
+  std::function<std::vector<double>(const std::vector<double> &)> all_gather;
+  /// @endcond
 };
 
+/// @brief Summary statistics of per-iteration time samples, in seconds.
+struct PerfStatistics {
+  double min = 0.0;
+  double median = 0.0;
+  double mean = 0.0;
+  double p95 = 0.0;
+  double stddev = 0.0;
+  /// @brief Lower bound of the bootstrap confidence interval for the median.
+  double ci_low = 0.0;
+  /// @brief Upper bound of the bootstrap confidence interval for the median.
+  double ci_high = 0.0;
+};
+
+/// @brief Returns the q-quantile of samples using linear interpolation.
+/// @param samples Time samples (need not be sorted).
+/// @param q Quantile in [0, 1].
+/// @return Interpolated quantile, or 0 if there are no samples.
+double Percentile(std::vector<double> samples, double q);
+
+/// @brief Computes summary statistics and a bootstrap confidence interval for the median.
+/// @param samples Per-iteration time samples in seconds.
+/// @param confidence_level Confidence level of the interval, e.g. 0.95.
+/// @param bootstrap_resamples Number of bootstrap resamples.
+/// @return Statistics of the samples; all zeros if there are no samples.
+PerfStatistics ComputePerfStatistics(const std::vector<double> &samples, double confidence_level,
+                                     uint64_t bootstrap_resamples);
+
+/// @brief Size of the last-level CPU cache in bytes.
+/// @return Detected size, or 0 if it cannot be determined on this platform.
+std::size_t DetectLastLevelCacheBytes();
+
+/// @brief Evicts the caches of the calling core by writing and reading a buffer of the given size.
+/// @param bytes Buffer size; should exceed the last-level cache to flush it completely.
+void EvictCaches(std::size_t bytes);
+
+/// @brief Hardware events counted around the measured iterations.
+enum class HardwareCounter : uint8_t {
+  kCycles,
+  kInstructions,
+  /// Last-level cache misses as reported by the generic PERF_COUNT_HW_CACHE_MISSES event
+  kLlcMisses,
+  kBranchMisses,
+  /// Backend stall cycles; many CPUs do not expose this event
+  kStalledCycles,
+};
+
+inline constexpr std::size_t kNumHardwareCounters = 5;
+
+/// @brief Names of the hardware counters in the perf output, indexed by HardwareCounter.
+inline constexpr std::array<std::string_view, kNumHardwareCounters> kHardwareCounterNames = {
+    "cycles", "instructions", "llc_misses", "branch_misses", "stalled_cycles"};
+
+/// @brief Value of every hardware counter; empty for counters that could not be collected.
+using HardwareCounterValues = std::array<std::optional<double>, kNumHardwareCounters>;
+
+/// @brief Group of Linux perf_event_open counters of the calling process.
+/// @details Every counter is opened disabled on each thread that exists at construction, including the
+///          OpenMP, TBB and pool workers the runner started in advance, and inherited by threads created
+///          later; Read() sums the threads. Counters are counted only between Start() and Stop(). Counters
+///          that cannot be opened, for example in containers or on other systems, are skipped silently.
+class HardwareCounters {
+ public:
+  HardwareCounters();
+  HardwareCounters(const HardwareCounters &) = delete;
+  HardwareCounters &operator=(const HardwareCounters &) = delete;
+  HardwareCounters(HardwareCounters &&) = delete;
+  HardwareCounters &operator=(HardwareCounters &&) = delete;
+  ~HardwareCounters();
+
+  /// @brief Returns true if at least one counter could be opened.
+  [[nodiscard]] bool Available() const;
+  /// @brief Resumes counting.
+  void Start();
+  /// @brief Pauses counting.
+  void Stop();
+  /// @brief Reads the accumulated counts, scaled up if the kernel multiplexed the counters.
+  [[nodiscard]] HardwareCounterValues Read() const;
+
+ private:
+  static void CloseAll(std::vector<int> &fds);
+
+  /// One descriptor per thread for every counter; empty if the counter is unavailable
+  std::array<std::vector<int>, kNumHardwareCounters> fds_{};
+};
+
+/// @brief Instructions per cycle of the counted region.
+/// @return IPC, or std::nullopt if cycles or instructions are unavailable.
+std::optional<double> InstructionsPerCycle(const HardwareCounterValues &counters);
+
+/// @brief Distribution of a measured value across MPI ranks, in seconds.
+struct RankStatistics {
+  double min = 0.0;
+  double max = 0.0;
+  double mean = 0.0;
+  /// @brief Load-imbalance ratio max / mean; 1.0 means perfectly balanced ranks.
+  double imbalance = 1.0;
+};
+
+/// @brief Cross-rank distribution of the measured time and of every pipeline stage.
+struct RankReport {
+  /// @brief Number of ranks that contributed to the report.
+  int num_ranks = 1;
+  RankStatistics time;
+  RankStatistics validation;
+  RankStatistics pre_processing;
+  RankStatistics run;
+  RankStatistics post_processing;
+};
+
+/// @brief Computes min, max, mean and the imbalance ratio of per-rank values.
+/// @param values One value per rank.
+/// @return Cross-rank statistics; imbalance is 1 if the mean is not positive.
+RankStatistics ComputeRankStatistics(const std::vector<double> &values);
+
+/// @brief MPI calls summed over peers.
+struct MpiCallTotals {
+  uint64_t calls = 0;
+  uint64_t bytes = 0;
+  double time_sec = 0.0;
+};
+
+/// @brief Sums the profiled MPI calls of one task stage per function.
+/// @param profile Entries returned by ppc::util::TakeMpiProfile().
+/// @param stage Task stage, e.g. "run".
+/// @return Totals keyed by MPI function name.
+std::map<std::string, MpiCallTotals> SummarizeMpiProfile(const std::vector<ppc::util::MpiProfileEntry> &profile,
+                                                         std::string_view stage);
+
+/// @brief Bytes this rank sent to every rank in point-to-point calls of one task stage.
+/// @param profile Entries returned by ppc::util::TakeMpiProfile().
+/// @param stage Task stage, e.g. "run".
+/// @param num_ranks Size of MPI_COMM_WORLD; peers outside [0, num_ranks) are ignored.
+/// @return One value per destination rank.
+std::vector<double> CommunicationRow(const std::vector<ppc::util::MpiProfileEntry> &profile, std::string_view stage,
+                                     int num_ranks);
+
 struct PerfResults {
-  /// @brief Measured execution time in seconds.
+  /// @brief Measured execution time in seconds (median of the per-iteration samples).
   double time_sec = 0.0;
+  /// @brief Duration of every measured iteration in seconds.
+  std::vector<double> samples;
+  /// @brief Summary statistics of the samples.
+  PerfStatistics statistics;
+  /// @brief Duration of every cold-cache iteration in seconds (filled when PerfAttr::cold_cache is set).
+  std::vector<double> cold_samples;
+  /// @brief Summary statistics of the cold-cache samples.
+  PerfStatistics cold_statistics;
   enum class TypeOfRunning : uint8_t {
     kPipeline,
     kTaskRun,
     kNone,
   };
   TypeOfRunning type_of_running = TypeOfRunning::kNone;
+  /// @brief Per-stage durations of the task collected during the measured run.
+  ppc::task::TaskStats stage_stats;
+  /// @brief Cross-rank aggregation of time and stage durations (filled when PerfAttr::all_gather is set).
+  RankReport rank_report;
+  /// @brief Hardware counts per measured iteration, summed over ranks (filled when PerfAttr::hardware_counters
+  ///        is set).
+  HardwareCounterValues counters{};
+  /// @brief MPI calls of this rank made by the task during the measured run, per stage (filled when the build
+  ///        enables MPI profiling).
+  std::vector<ppc::util::MpiProfileEntry> mpi_profile;
+  /// @brief Row-major matrix of bytes sent from rank i to rank j per Run() call (filled on multi-rank runs when
+  ///        the build enables MPI profiling).
+  std::vector<double> comm_matrix;
+  /// @brief Throughput of Run() against the machine peaks (filled when PerfAttr::bytes_moved or
+  ///        PerfAttr::flops is declared).
+  std::optional<RooflineReport> roofline;
+  /// @brief Peak resident set size of this process after the measured run, in bytes (0 if unknown).
+  uint64_t peak_rss_bytes = 0;
+  /// @brief Problem size of the measured input (0 if unknown).
+  uint64_t input_size = 0;
   constexpr static double kMaxTime = 10.0;
 };
 
+/// @brief Best-effort element count of a task input.
+/// @return Size of a sized range, sum over the members of a tuple-like value, 1 for an arithmetic
+///         value and 0 if the size cannot be deduced.
+template <typename T>
+uint64_t EstimateInputSize(const T &input) {
+  if constexpr (std::ranges::sized_range<const T>) {
+    return static_cast<uint64_t>(std::ranges::size(input));
+  } else if constexpr (std::is_arithmetic_v<T>) {
+    return 1;
+  } else if constexpr (requires { std::tuple_size<T>::value; }) {
+    return std::apply([](const auto &...members) { return (uint64_t{0} + ... + EstimateInputSize(members)); },
+                      input);
+  } else {
+    return 0;
+  }
+}
+
+/// @brief Builds the structured record of one performance test.
+/// @param results Measured results.
+/// @param test_id Test name used in the legacy stdout line, e.g. "<namespace>_mpi_enabled".
+/// @param backend Technology of the task, e.g. "mpi".
+/// @param mode Type of running: "pipeline" or "task_run".
+/// @return Flat record with identification, counts, timing statistics, hostname and git revision.
+nlohmann::ordered_json MakePerfRecord(const PerfResults &results, const std::string &test_id,
+                                      const std::string &backend, const std::string &mode);
+
+/// @brief Appends a record to "<file_stem>.<format>" inside the output directory.
+/// @param record Record created by MakePerfRecord().
+/// @param output_dir Directory for the results file; created if missing.
+/// @param format "jsonl" (one JSON object per line) or "csv" (header written once).
+/// @param file_stem Name of the results file without extension.
+/// @throws std::runtime_error If the format is unknown or the file cannot be written.
+void WritePerfRecord(const nlohmann::ordered_json &record, const std::string &output_dir, const std::string &format,
+                     const std::string &file_stem = "perf_results");
+
+/// @brief Stored reference results of one test id and type of running.
+struct PerfBaseline {
+  double median_sec = 0.0;
+  /// @brief Per-iteration samples of the reference run (may be empty for hand-written baselines).
+  std::vector<double> samples;
+};
+
+/// @brief Outcome of comparing a run against its baseline.
+struct RegressionCheck {
+  /// @brief Current median divided by the baseline median.
+  double ratio = 1.0;
+  /// @brief One-sided Mann-Whitney p-value that the current samples are slower than the baseline ones.
+  double p_value = 1.0;
+  bool regressed = false;
+};
+
+/// @brief One-sided Mann-Whitney U test (normal approximation) that `current` tends to be larger than `baseline`.
+/// @return p-value of the test, or 1 if either sample is empty.
+double MannWhitneyGreaterPValue(const std::vector<double> &current, const std::vector<double> &baseline);
+
+/// @brief Flags a regression when the median slowed down by more than the threshold and, if the baseline
+///        has samples, the slowdown is statistically significant.
+/// @param baseline Stored reference results.
+/// @param results Results of the current run.
+/// @param threshold Allowed relative slowdown, e.g. 0.1 for 10 %.
+/// @param significance Significance level of the Mann-Whitney test.
+RegressionCheck CheckRegression(const PerfBaseline &baseline, const PerfResults &results, double threshold,
+                                double significance = 0.05);
+
+/// @brief Loads the baseline of a test from a JSON baseline file.
+/// @return The baseline, or std::nullopt if the file or the entry does not exist.
+/// @throws std::runtime_error If the file exists but is not valid JSON.
+std::optional<PerfBaseline> LoadPerfBaseline(const std::string &path, const std::string &test_id,
+                                             const std::string &mode);
+
+/// @brief Stores the results of a test as its new baseline, keeping the entries of other tests.
+/// @throws std::runtime_error If the file cannot be written.
+void StorePerfBaseline(const std::string &path, const std::string &test_id, const std::string &mode,
+                       const PerfResults &results);
+
+/// @brief Thread counts of a scaling sweep: powers of two below max_threads followed by max_threads itself.
+/// @return {1, 2, 4, ..., max_threads}; {1} if max_threads < 2.
+std::vector<int> ThreadSweepCounts(int max_threads);
+
+/// @brief Problem sizes of a size sweep: max_size halved repeatedly, in ascending order.
+/// @return Up to num_sizes distinct positive sizes ending with max_size.
+std::vector<std::size_t> SizeLadder(std::size_t max_size, std::size_t num_sizes);
+
+/// @brief Power-law model time = coefficient * n^exponent fitted to measured times.
+struct ComplexityFit {
+  /// @brief Observed complexity exponent, e.g. about 1 for linear and about 2 for quadratic kernels.
+  double exponent = 0.0;
+  /// @brief Fitted time of a single element in seconds.
+  double coefficient = 0.0;
+  /// @brief Coefficient of determination of the fit in log-log space.
+  double r_squared = 0.0;
+};
+
+/// @brief Fits time = coefficient * n^exponent by least squares in log-log space.
+/// @param sizes Problem sizes; points with a non-positive size or time are ignored.
+/// @param times Measured times in seconds, one per size.
+/// @return The fit, or all zeros if fewer than two distinct sizes remain.
+ComplexityFit FitComplexity(const std::vector<double> &sizes, const std::vector<double> &times);
+
 template <typename InType, typename OutType>
 class Perf {
  public:
@@ -50,22 +367,67 @@ class Perf {
   // Validation() -> Run() -> PostProcessing()
   void PipelineRun(const PerfAttr &perf_attr) {
     perf_results_.type_of_running = PerfResults::TypeOfRunning::kPipeline;
+    SetInputSize(perf_attr);
 
-    CommonRun(perf_attr, [&] {
+    auto pipeline = [&] {
       task_->Validation();
       task_->PreProcessing();
       task_->Run();
       task_->PostProcessing();
-    }, perf_results_);
+    };
+    Warmup(perf_attr, pipeline);
+    task_->ResetTaskStats();
+    ppc::util::TakeMpiProfile();
+    CommonRun(perf_attr, pipeline, perf_results_);
+    perf_results_.stage_stats = task_->GetTaskStats();
+    perf_results_.mpi_profile = ppc::util::TakeMpiProfile();
+    // The stage statistics and the MPI profile are taken before, so they describe the warm iterations only
+    ColdRun(perf_attr, pipeline, perf_results_);
+    ppc::util::TakeMpiProfile();
+    BuildCommunicationMatrix(perf_attr, perf_results_);
+    perf_results_.peak_rss_bytes = ppc::util::GetPeakRssBytes();
+    AggregateRanks(perf_attr, perf_results_);
+    // The pipeline time includes the other stages, so the throughput refers to the Run() stage alone
+    MeasureRoofline(perf_attr, perf_results_.stage_stats.run.MeanSec());
   }
   // Check performance of task's Run() function
   void TaskRun(const PerfAttr &perf_attr) {
     perf_results_.type_of_running = PerfResults::TypeOfRunning::kTaskRun;
+    SetInputSize(perf_attr);
 
+    task_->ResetTaskStats();
+    ppc::util::TakeMpiProfile();
     task_->Validation();
     task_->PreProcessing();
-    CommonRun(perf_attr, [&] { task_->Run(); }, perf_results_);
+    const auto setup_stats = task_->GetTaskStats();
+    const auto setup_profile = ppc::util::TakeMpiProfile();
+    std::function<void()> restore;
+    if (perf_attr.restore_run_state) {
+      task_->SnapshotRunState();
+      restore = [&] { task_->RestoreRunState(); };
+    }
+    auto run = [&] { task_->Run(); };
+    Warmup(perf_attr, run, restore);
+    task_->ResetTaskStats();
+    ppc::util::TakeMpiProfile();
+    CommonRun(perf_attr, run, perf_results_, restore);
+    const auto run_stats = task_->GetTaskStats().run;
+    perf_results_.mpi_profile = ppc::util::TakeMpiProfile();
+    // The Run() statistics and the MPI profile are taken before, so they describe the warm iterations only
+    ColdRun(perf_attr, run, perf_results_, restore);
+    ppc::util::TakeMpiProfile();
     task_->PostProcessing();
+    perf_results_.stage_stats = task_->GetTaskStats();
+    perf_results_.stage_stats.validation = setup_stats.validation;
+    perf_results_.stage_stats.pre_processing = setup_stats.pre_processing;
+    perf_results_.stage_stats.run = run_stats;
+    const auto post_profile = ppc::util::TakeMpiProfile();
+    perf_results_.mpi_profile.insert(perf_results_.mpi_profile.end(), post_profile.begin(), post_profile.end());
+    perf_results_.mpi_profile.insert(perf_results_.mpi_profile.end(), setup_profile.begin(), setup_profile.end());
+    BuildCommunicationMatrix(perf_attr, perf_results_);
+    perf_results_.peak_rss_bytes = ppc::util::GetPeakRssBytes();
+    AggregateRanks(perf_attr, perf_results_);
+    MeasureRoofline(perf_attr, perf_results_.time_sec);
 
     task_->Validation();
     task_->PreProcessing();
@@ -91,6 +453,15 @@ class Perf {
     if (time_secs < max_time) {
       perf_res_str << std::fixed << std::setprecision(10) << time_secs;
       std::cout << test_id << ":" << type_test_name << ":" << perf_res_str.str() << '\n';
+      PrintSampleStatistic(test_id, type_test_name);
+      PrintColdStatistic(test_id, type_test_name);
+      PrintStageStatistic(test_id, type_test_name);
+      PrintRankStatistic(test_id, type_test_name);
+      PrintCounterStatistic(test_id, type_test_name);
+      PrintMpiStatistic(test_id, type_test_name);
+      PrintRooflineStatistic(test_id, type_test_name);
+      WriteStructuredRecord(test_id, type_test_name);
+      CompareWithBaseline(test_id, type_test_name);
     } else {
       std::stringstream err_msg;
       err_msg << '\n' << "Task execute time need to be: ";
@@ -98,6 +469,8 @@ class Perf {
       err_msg << "Original time in secs: " << time_secs << '\n';
       perf_res_str << std::fixed << std::setprecision(10) << -1.0;
       std::cout << test_id << ":" << type_test_name << ":" << perf_res_str.str() << '\n';
+      PrintStageStatistic(test_id, type_test_name);
+      WriteStructuredRecord(test_id, type_test_name);
       throw std::runtime_error(err_msg.str().c_str());
     }
   }
@@ -110,13 +483,416 @@ class Perf {
  private:
   PerfResults perf_results_;
   std::shared_ptr<ppc::task::Task<InType, OutType>> task_;
-  static void CommonRun(const PerfAttr &perf_attr, const std::function<void()> &pipeline, PerfResults &perf_results) {
-    auto begin = perf_attr.current_timer();
-    for (uint64_t i = 0; i < perf_attr.num_running; i++) {
+  // Update or check the stored baseline when PPC_PERF_BASELINE_FILE is set
+  void CompareWithBaseline(const std::string &test_id, const std::string &type_test_name) const {
+    const auto path = ppc::util::GetPerfBaselineFile();
+    if (path.empty()) {
+      return;
+    }
+    if (ppc::util::IsPerfBaselineUpdate()) {
+      StorePerfBaseline(path, test_id, type_test_name, perf_results_);
+      return;
+    }
+    const auto baseline = LoadPerfBaseline(path, test_id, type_test_name);
+    if (!baseline.has_value()) {
+      return;
+    }
+    const auto threshold = ppc::util::GetPerfRegressionThreshold();
+    const auto check = CheckRegression(baseline.value(), perf_results_, threshold);
+    std::stringstream ratio_str;
+    ratio_str << std::fixed << std::setprecision(10) << check.ratio;
+    std::cout << test_id << ":" << type_test_name << ":baseline_ratio:" << ratio_str.str() << '\n';
+    if (check.regressed) {
+      std::stringstream err_msg;
+      err_msg << '\n' << "Performance regression against the baseline: ";
+      err_msg << "median " << perf_results_.time_sec << " secs vs " << baseline->median_sec << " secs";
+      err_msg << " (x" << check.ratio << ", allowed x" << (1.0 + threshold) << ", p = " << check.p_value << ")."
+              << '\n';
+      throw std::runtime_error(err_msg.str().c_str());
+    }
+  }
+  // Probe the peaks of every rank at the same time, so that ranks sharing a node also share its bandwidth
+  void MeasureRoofline(const PerfAttr &perf_attr, double run_time_sec) {
+    perf_results_.roofline.reset();
+    if (perf_attr.bytes_moved == 0 && perf_attr.flops == 0) {
+      return;
+    }
+    const auto type_of_task = task_->GetDynamicTypeOfTask();
+    const bool threaded = type_of_task != ppc::task::TypeOfTask::kSEQ && type_of_task != ppc::task::TypeOfTask::kMPI;
+    if (perf_attr.barrier) {
+      perf_attr.barrier();
+    }
+    auto peaks = GetMachinePeaks(threaded ? ppc::util::GetNumThreads() : 1, ppc::util::mpi::GetWorldRanksOnNode());
+    if (perf_attr.all_gather) {
+      const auto gathered = perf_attr.all_gather({peaks.bandwidth_bytes_per_sec, peaks.flops_per_sec});
+      peaks = MachinePeaks{};
+      for (std::size_t rank = 0; rank < gathered.size() / 2; rank++) {
+        peaks.bandwidth_bytes_per_sec += gathered[2 * rank];
+        peaks.flops_per_sec += gathered[(2 * rank) + 1];
+      }
+    }
+    perf_results_.roofline = ComputeRoofline(perf_attr.bytes_moved, perf_attr.flops, run_time_sec, peaks);
+  }
+  // Print throughput as "test_id:type:throughput:quantity:value" and the peaks as "test_id:type:roofline:peak:value"
+  void PrintRooflineStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    if (!perf_results_.roofline.has_value()) {
+      return;
+    }
+    const auto &report = *perf_results_.roofline;
+    const std::array<std::tuple<const char *, const char *, double>, 6> values = {{
+        {"throughput", "bandwidth_gbs", report.bandwidth_bytes_per_sec / 1e9},
+        {"throughput", "gflops", report.flops_per_sec / 1e9},
+        {"throughput", "arithmetic_intensity", report.arithmetic_intensity},
+        {"throughput", "percent_of_roofline", report.percent_of_roofline},
+        {"roofline", "peak_bandwidth_gbs", report.peaks.bandwidth_bytes_per_sec / 1e9},
+        {"roofline", "peak_gflops", report.peaks.flops_per_sec / 1e9},
+    }};
+    for (const auto &[group, name, value] : values) {
+      std::stringstream value_str;
+      value_str << std::fixed << std::setprecision(4) << value;
+      std::cout << test_id << ":" << type_test_name << ":" << group << ":" << name << ":" << value_str.str() << '\n';
+    }
+  }
+  void SetInputSize(const PerfAttr &perf_attr) {
+    perf_results_.input_size =
+        (perf_attr.input_size != 0) ? perf_attr.input_size : EstimateInputSize(std::as_const(task_->GetInput()));
+  }
+  // Append the results to the structured sink when PPC_PERF_OUTPUT_DIR is set
+  void WriteStructuredRecord(const std::string &test_id, const std::string &type_test_name) const {
+    const auto output_dir = ppc::util::GetPerfOutputDir();
+    if (output_dir.empty()) {
+      return;
+    }
+    const auto record = MakePerfRecord(perf_results_, test_id,
+                                       ppc::task::TypeOfTaskToString(task_->GetDynamicTypeOfTask()), type_test_name);
+    WritePerfRecord(record, output_dir, ppc::util::GetPerfOutputFormat());
+  }
+  // Print summary statistics of the samples as "test_id:type:statistic:time"
+  void PrintSampleStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    if (perf_results_.samples.empty()) {
+      return;
+    }
+    PrintStatistics(test_id + ":" + type_test_name, perf_results_.statistics);
+  }
+  // Print cold-cache statistics as "test_id:type:cold:statistic:time"
+  void PrintColdStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    if (perf_results_.cold_samples.empty()) {
+      return;
+    }
+    PrintStatistics(test_id + ":" + type_test_name + ":cold", perf_results_.cold_statistics);
+  }
+  static void PrintStatistics(const std::string &prefix, const PerfStatistics &stats) {
+    const std::array<std::pair<const char *, double>, 7> values = {{
+        {"min", stats.min},
+        {"median", stats.median},
+        {"mean", stats.mean},
+        {"p95", stats.p95},
+        {"stddev", stats.stddev},
+        {"ci_low", stats.ci_low},
+        {"ci_high", stats.ci_high},
+    }};
+    for (const auto &[name, value] : values) {
+      std::stringstream value_str;
+      value_str << std::fixed << std::setprecision(10) << value;
+      std::cout << prefix << ":" << name << ":" << value_str.str() << '\n';
+    }
+  }
+  // Print mean per-call duration of every stage as "test_id:type:stage:time"
+  void PrintStageStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    const auto &stats = perf_results_.stage_stats;
+    const std::array<std::pair<const char *, const ppc::task::StageStats *>, 4> stages = {{
+        {"validation", &stats.validation},
+        {"pre_processing", &stats.pre_processing},
+        {"run", &stats.run},
+        {"post_processing", &stats.post_processing},
+    }};
+    for (const auto &[stage_name, stage_stats] : stages) {
+      if (stage_stats->calls == 0) {
+        continue;
+      }
+      std::stringstream stage_str;
+      stage_str << std::fixed << std::setprecision(10) << stage_stats->MeanSec();
+      std::cout << test_id << ":" << type_test_name << ":" << stage_name << ":" << stage_str.str() << '\n';
+      if constexpr (ppc::util::IsAllocationTrackingEnabled()) {
+        PrintStageAllocations(test_id + ":" + type_test_name + ":" + stage_name, *stage_stats);
+      }
+    }
+    if (perf_results_.peak_rss_bytes != 0) {
+      std::cout << test_id << ":" << type_test_name << ":peak_rss_bytes:" << perf_results_.peak_rss_bytes << '\n';
+    }
+  }
+  // Print per-call allocations of a stage as "test_id:type:stage:quantity:value"
+  static void PrintStageAllocations(const std::string &prefix, const ppc::task::StageStats &stage_stats) {
+    const auto calls = static_cast<double>(stage_stats.calls);
+    const std::array<std::pair<const char *, double>, 3> values = {{
+        {"allocations", static_cast<double>(stage_stats.allocations) / calls},
+        {"allocated_bytes", static_cast<double>(stage_stats.allocated_bytes) / calls},
+        {"peak_heap_bytes", static_cast<double>(stage_stats.peak_heap_bytes)},
+    }};
+    for (const auto &[name, value] : values) {
+      std::stringstream value_str;
+      value_str << std::fixed << std::setprecision(1) << value;
+      std::cout << prefix << ":" << name << ":" << value_str.str() << '\n';
+    }
+  }
+  // Print cross-rank distribution as "test_id:type:quantity:statistic:value"
+  void PrintRankStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    const auto &report = perf_results_.rank_report;
+    if (report.num_ranks <= 1) {
+      return;
+    }
+    const std::array<std::pair<const char *, const RankStatistics *>, 5> quantities = {{
+        {"time", &report.time},
+        {"validation", &report.validation},
+        {"pre_processing", &report.pre_processing},
+        {"run", &report.run},
+        {"post_processing", &report.post_processing},
+    }};
+    for (const auto &[name, stats] : quantities) {
+      const std::array<std::pair<const char *, double>, 4> values = {{
+          {"rank_min", stats->min},
+          {"rank_max", stats->max},
+          {"rank_mean", stats->mean},
+          {"imbalance", stats->imbalance},
+      }};
+      for (const auto &[stat_name, value] : values) {
+        std::stringstream value_str;
+        value_str << std::fixed << std::setprecision(10) << value;
+        std::cout << test_id << ":" << type_test_name << ":" << name << ":" << stat_name << ":" << value_str.str()
+                  << '\n';
+      }
+    }
+  }
+  // Print per-iteration hardware counts as "test_id:type:counters:name:value"; unavailable counters are skipped
+  void PrintCounterStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    const auto &counters = perf_results_.counters;
+    const std::string prefix = test_id + ":" + type_test_name + ":counters:";
+    for (std::size_t counter = 0; counter < counters.size(); counter++) {
+      if (counters[counter].has_value()) {
+        std::stringstream value_str;
+        value_str << std::fixed << std::setprecision(0) << *counters[counter];
+        std::cout << prefix << kHardwareCounterNames[counter] << ":" << value_str.str() << '\n';
+      }
+    }
+    const auto ipc = InstructionsPerCycle(counters);
+    if (ipc.has_value()) {
+      std::stringstream ipc_str;
+      ipc_str << std::fixed << std::setprecision(10) << *ipc;
+      std::cout << prefix << "ipc:" << ipc_str.str() << '\n';
+    }
+  }
+  // Print per-call MPI traffic of every stage as "test_id:type:mpi:stage:function:quantity:value" and the
+  // communication matrix as "test_id:type:comm_matrix:source:destination:bytes"
+  void PrintMpiStatistic(const std::string &test_id, const std::string &type_test_name) const {
+    const auto &stats = perf_results_.stage_stats;
+    const std::array<std::pair<const char *, const ppc::task::StageStats *>, 4> stages = {{
+        {"validation", &stats.validation},
+        {"pre_processing", &stats.pre_processing},
+        {"run", &stats.run},
+        {"post_processing", &stats.post_processing},
+    }};
+    for (const auto &[stage_name, stage_stats] : stages) {
+      if (stage_stats->calls == 0) {
+        continue;
+      }
+      const auto calls = static_cast<double>(stage_stats->calls);
+      for (const auto &[function, totals] : SummarizeMpiProfile(perf_results_.mpi_profile, stage_name)) {
+        const std::string prefix = test_id + ":" + type_test_name + ":mpi:" + stage_name + ":" + function + ":";
+        std::stringstream calls_str;
+        std::stringstream bytes_str;
+        std::stringstream time_str;
+        calls_str << std::fixed << std::setprecision(1) << static_cast<double>(totals.calls) / calls;
+        bytes_str << std::fixed << std::setprecision(1) << static_cast<double>(totals.bytes) / calls;
+        time_str << std::fixed << std::setprecision(10) << totals.time_sec / calls;
+        std::cout << prefix << "calls:" << calls_str.str() << '\n';
+        std::cout << prefix << "bytes:" << bytes_str.str() << '\n';
+        std::cout << prefix << "time:" << time_str.str() << '\n';
+      }
+    }
+    const auto &matrix = perf_results_.comm_matrix;
+    const auto num_ranks = static_cast<std::size_t>(perf_results_.rank_report.num_ranks);
+    if (matrix.size() != num_ranks * num_ranks) {
+      return;
+    }
+    for (std::size_t source = 0; source < num_ranks; source++) {
+      for (std::size_t destination = 0; destination < num_ranks; destination++) {
+        const double bytes = matrix[(source * num_ranks) + destination];
+        if (bytes == 0.0) {
+          continue;
+        }
+        std::stringstream bytes_str;
+        bytes_str << std::fixed << std::setprecision(1) << bytes;
+        std::cout << test_id << ":" << type_test_name << ":comm_matrix:" << source << ":" << destination << ":"
+                  << bytes_str.str() << '\n';
+      }
+    }
+  }
+  // Every rank contributes the row of bytes it sent per Run() call
+  static void BuildCommunicationMatrix(const PerfAttr &perf_attr, PerfResults &perf_results) {
+    perf_results.comm_matrix.clear();
+    if (!ppc::util::IsMpiProfilingEnabled() || !perf_attr.all_gather) {
+      return;
+    }
+    const auto num_ranks = static_cast<int>(perf_attr.all_gather({0.0}).size());
+    auto row = CommunicationRow(perf_results.mpi_profile, "run", num_ranks);
+    const auto run_calls = perf_results.stage_stats.run.calls;
+    for (auto &bytes : row) {
+      bytes = (run_calls != 0) ? bytes / static_cast<double>(run_calls) : 0.0;
+    }
+    perf_results.comm_matrix = perf_attr.all_gather(row);
+  }
+  static void AggregateRanks(const PerfAttr &perf_attr, PerfResults &perf_results) {
+    perf_results.rank_report = RankReport{};
+    if (!perf_attr.all_gather) {
+      return;
+    }
+    const auto &stats = perf_results.stage_stats;
+    const std::vector<double> local = {perf_results.time_sec, stats.validation.MeanSec(),
+                                       stats.pre_processing.MeanSec(), stats.run.MeanSec(),
+                                       stats.post_processing.MeanSec()};
+    const auto gathered = perf_attr.all_gather(local);
+    const std::size_t num_ranks = gathered.size() / local.size();
+    std::array<RankStatistics *, 5> targets = {&perf_results.rank_report.time, &perf_results.rank_report.validation,
+                                               &perf_results.rank_report.pre_processing,
+                                               &perf_results.rank_report.run,
+                                               &perf_results.rank_report.post_processing};
+    for (std::size_t quantity = 0; quantity < targets.size(); quantity++) {
+      std::vector<double> per_rank(num_ranks);
+      for (std::size_t rank = 0; rank < num_ranks; rank++) {
+        per_rank[rank] = gathered[(rank * local.size()) + quantity];
+      }
+      *targets[quantity] = ComputeRankStatistics(per_rank);
+    }
+    perf_results.rank_report.num_ranks = static_cast<int>(num_ranks);
+  }
+  // A counter is reported only if every rank could collect it
+  static void SumCountersOverRanks(const PerfAttr &perf_attr, HardwareCounterValues &counters) {
+    if (!perf_attr.all_gather) {
+      return;
+    }
+    std::vector<double> local(counters.size());
+    std::ranges::transform(counters, local.begin(), [](const auto &value) { return value.value_or(-1.0); });
+    const auto gathered = perf_attr.all_gather(local);
+    for (std::size_t counter = 0; counter < counters.size(); counter++) {
+      double total = 0.0;
+      bool available = true;
+      for (std::size_t rank = 0; rank < gathered.size() / local.size(); rank++) {
+        const double value = gathered[(rank * local.size()) + counter];
+        available = available && value >= 0.0;
+        total += value;
+      }
+      counters[counter] = available ? std::optional<double>(total) : std::nullopt;
+    }
+  }
+  // Ranks must agree on the iteration count, otherwise collective calls inside the task would deadlock
+  static bool AnyRank(const PerfAttr &perf_attr, bool value) {
+    if (!perf_attr.all_gather) {
+      return value;
+    }
+    const auto votes = perf_attr.all_gather({value ? 1.0 : 0.0});
+    return std::ranges::any_of(votes, [](double vote) { return vote != 0.0; });
+  }
+  static void Warmup(const PerfAttr &perf_attr, const std::function<void()> &pipeline,
+                     const std::function<void()> &prepare = {}) {
+    for (uint64_t i = 0; i < perf_attr.num_warmup; i++) {
+      if (prepare) {
+        prepare();
+      }
       pipeline();
     }
-    auto end = perf_attr.current_timer();
-    perf_results.time_sec = (end - begin) / static_cast<double>(perf_attr.num_running);
+  }
+  static bool IsConfidenceIntervalTight(const PerfAttr &perf_attr, const PerfStatistics &stats) {
+    if (stats.median <= 0.0) {
+      return true;
+    }
+    return (stats.ci_high - stats.ci_low) / 2.0 <= perf_attr.target_relative_ci * stats.median;
+  }
+  // Times count iterations into target; prepare runs before every iteration outside the timed region and
+  // flush_bytes != 0 evicts the caches there as well
+  static void RunIterations(const PerfAttr &perf_attr, const std::function<void()> &pipeline,
+                            const std::function<void()> &prepare, uint64_t count, std::vector<double> &target,
+                            std::size_t flush_bytes = 0, HardwareCounters *counters = nullptr) {
+    for (uint64_t i = 0; i < count; i++) {
+      if (prepare) {
+        prepare();
+      }
+      if (flush_bytes != 0) {
+        EvictCaches(flush_bytes);
+      }
+      if (perf_attr.barrier) {
+        const ppc::util::TraceScope trace_scope("barrier", "perf");
+        perf_attr.barrier();
+      }
+      if (counters != nullptr) {
+        counters->Start();
+      }
+      const auto begin = perf_attr.current_timer();
+      pipeline();
+      const auto end = perf_attr.current_timer();
+      if (counters != nullptr) {
+        counters->Stop();
+      }
+      target.push_back(end - begin);
+    }
+  }
+  // Warm iterations: the samples, statistics and hardware counters that the test reports
+  static void CommonRun(const PerfAttr &perf_attr, const std::function<void()> &pipeline, PerfResults &perf_results,
+                        const std::function<void()> &prepare = {}) {
+    auto &samples = perf_results.samples;
+    samples.clear();
+    perf_results.counters = HardwareCounterValues{};
+    std::unique_ptr<HardwareCounters> counters;
+    if (perf_attr.hardware_counters) {
+      counters = std::make_unique<HardwareCounters>();
+    }
+    auto run_iterations = [&](uint64_t count) {
+      RunIterations(perf_attr, pipeline, prepare, count, samples, 0, counters.get());
+    };
+
+    const auto budget_begin = perf_attr.current_timer();
+    run_iterations(perf_attr.num_running);
+    auto stats = ComputePerfStatistics(samples, perf_attr.confidence_level, perf_attr.bootstrap_resamples);
+    if (perf_attr.adaptive) {
+      // Grow the sample in batches of num_running until the CI is tight or a limit is reached
+      while (AnyRank(perf_attr, !IsConfidenceIntervalTight(perf_attr, stats) &&
+                                    samples.size() < perf_attr.max_running &&
+                                    perf_attr.current_timer() - budget_begin < perf_attr.time_budget_sec)) {
+        run_iterations(std::min<uint64_t>(std::max<uint64_t>(perf_attr.num_running, 1),
+                                          perf_attr.max_running - samples.size()));
+        stats = ComputePerfStatistics(samples, perf_attr.confidence_level, perf_attr.bootstrap_resamples);
+      }
+    }
+    perf_results.statistics = stats;
+    perf_results.time_sec = stats.median;
+    if (counters) {
+      perf_results.counters = counters->Read();
+      for (auto &value : perf_results.counters) {
+        if (value.has_value() && !samples.empty()) {
+          *value /= static_cast<double>(samples.size());
+        }
+      }
+      SumCountersOverRanks(perf_attr, perf_results.counters);
+    }
+  }
+  // Cold iterations, reported only as cold samples and cold statistics
+  static void ColdRun(const PerfAttr &perf_attr, const std::function<void()> &pipeline, PerfResults &perf_results,
+                      const std::function<void()> &prepare = {}) {
+    perf_results.cold_samples.clear();
+    perf_results.cold_statistics = PerfStatistics{};
+    if (!perf_attr.cold_cache) {
+      return;
+    }
+    const std::size_t flush_bytes =
+        (perf_attr.cache_flush_bytes != 0) ? perf_attr.cache_flush_bytes : DefaultCacheFlushBytes();
+    // Every cold iteration starts after the eviction buffer has pushed the task data out of the caches
+    RunIterations(perf_attr, pipeline, prepare, perf_attr.num_running, perf_results.cold_samples, flush_bytes);
+    perf_results.cold_statistics =
+        ComputePerfStatistics(perf_results.cold_samples, perf_attr.confidence_level, perf_attr.bootstrap_resamples);
+  }
+  static std::size_t DefaultCacheFlushBytes() {
+    constexpr std::size_t kFallbackBytes = std::size_t{64} << 20;
+    const std::size_t llc_bytes = DetectLastLevelCacheBytes();
+    return (llc_bytes != 0) ? 2 * llc_bytes : kFallbackBytes;
   }
 };
 
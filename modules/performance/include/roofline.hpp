@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ppc::performance {
+
+/// @brief Attainable memory bandwidth and floating-point rate of the calling process.
+struct MachinePeaks {
+  /// @brief STREAM triad bandwidth in bytes per second.
+  double bandwidth_bytes_per_sec = 0.0;
+  /// @brief Double-precision multiply-add rate in floating-point operations per second.
+  double flops_per_sec = 0.0;
+};
+
+/// @brief Measures the STREAM triad bandwidth a[i] = b[i] + s * c[i] (24 bytes per element, best of several runs).
+/// @param array_bytes Size of each of the three arrays; STREAM requires at least four times the last-level cache.
+/// @param num_threads Number of OpenMP threads running the kernel.
+/// @return Bandwidth in bytes per second.
+double MeasureStreamBandwidth(std::size_t array_bytes, int num_threads);
+
+/// @brief Measures the double-precision rate of independent multiply-add chains that fit into registers.
+/// @details The kernel is built with the project flags, so the result is the peak attainable by code compiled the
+///          same way rather than the theoretical peak of the CPU.
+/// @param num_threads Number of OpenMP threads running the kernel.
+/// @return Floating-point operations per second.
+double MeasurePeakFlops(int num_threads);
+
+/// @brief STREAM array size of one of ranks_per_node ranks probing at the same time.
+/// @details The three arrays of all ranks of the node together span at least four times the last-level cache
+///          (at least 32 MB and at most 256 MB per array in total), so every rank gets a share of that footprint.
+std::size_t StreamArrayBytes(std::size_t last_level_cache_bytes, int ranks_per_node);
+
+/// @brief Measures the peaks once per thread count and returns the cached values afterwards.
+/// @param num_threads Number of OpenMP threads running the probes.
+/// @param ranks_per_node Number of ranks of the node that probe at the same time and share its memory.
+MachinePeaks GetMachinePeaks(int num_threads, int ranks_per_node = 1);
+
+/// @brief Throughput of a measured kernel relative to the roofline of the machine.
+struct RooflineReport {
+  /// @brief Achieved bytes per second; 0 if no byte count was declared.
+  double bandwidth_bytes_per_sec = 0.0;
+  /// @brief Achieved floating-point operations per second; 0 if no flop count was declared.
+  double flops_per_sec = 0.0;
+  /// @brief Flops per byte; 0 if either count was not declared.
+  double arithmetic_intensity = 0.0;
+  /// @brief Achieved share of the roof in percent: of min(peak flops, intensity * peak bandwidth) when flops are
+  ///        declared, otherwise of the peak bandwidth.
+  double percent_of_roofline = 0.0;
+  MachinePeaks peaks;
+};
+
+/// @brief Places a measured kernel on the roofline.
+/// @param bytes Bytes moved by one execution of the kernel.
+/// @param flops Floating-point operations done by one execution of the kernel.
+/// @param time_sec Duration of one execution in seconds.
+/// @param peaks Peaks of the processes that executed the kernel.
+RooflineReport ComputeRoofline(uint64_t bytes, uint64_t flops, double time_sec, const MachinePeaks &peaks);
+
+}  // namespace ppc::performance
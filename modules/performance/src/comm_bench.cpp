@@ -0,0 +1,219 @@
+#include "performance/include/comm_bench.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "performance/include/performance.hpp"
+#include "util/include/util.hpp"
+
+namespace {
+
+constexpr std::size_t kTargetBytes = std::size_t{256} << 20;
+constexpr uint64_t kMinIterations = 2;
+constexpr uint64_t kMaxIterations = 1000;
+constexpr int kBenchTag = 0;
+
+int ToCount(std::size_t bytes) {
+  if (bytes > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    throw std::invalid_argument("Message of " + std::to_string(bytes) + " bytes exceeds the MPI count range");
+  }
+  return static_cast<int>(bytes);
+}
+
+// Block distribution of a buffer with the remainder spread over the first ranks
+struct BytePartition {
+  std::vector<int> counts;
+  std::vector<int> displs;
+};
+
+BytePartition PartitionBytes(std::size_t bytes, int processes) {
+  BytePartition partition;
+  partition.counts.resize(static_cast<std::size_t>(processes));
+  partition.displs.resize(static_cast<std::size_t>(processes));
+  const std::size_t base = bytes / static_cast<std::size_t>(processes);
+  const std::size_t remainder = bytes % static_cast<std::size_t>(processes);
+  std::size_t offset = 0;
+  for (std::size_t rank = 0; rank < partition.counts.size(); rank++) {
+    const std::size_t count = base + (rank < remainder ? 1 : 0);
+    partition.counts[rank] = ToCount(count);
+    partition.displs[rank] = ToCount(offset);
+    offset += count;
+  }
+  return partition;
+}
+
+// The first call is untimed: it pays for connection setup and buffer registration
+double TimeOperation(const std::function<void()> &operation, uint64_t iterations, MPI_Comm comm) {
+  operation();
+  MPI_Barrier(comm);
+  const double begin = MPI_Wtime();
+  for (uint64_t i = 0; i < iterations; i++) {
+    operation();
+  }
+  const double local = (MPI_Wtime() - begin) / static_cast<double>(iterations);
+  double slowest = 0.0;
+  MPI_Allreduce(&local, &slowest, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return slowest;
+}
+
+}  // namespace
+
+uint64_t ppc::performance::CommBenchIterations(std::size_t bytes) {
+  return std::clamp<uint64_t>(kTargetBytes / std::max<std::size_t>(bytes, 1), kMinIterations, kMaxIterations);
+}
+
+std::vector<std::size_t> ppc::performance::CommBenchSizes(std::size_t max_bytes) {
+  const std::size_t top = std::bit_floor(max_bytes);
+  return SizeLadder(top, static_cast<std::size_t>(std::bit_width(top)));
+}
+
+bool ppc::performance::IsCommBenchmarkApplicable(CommBenchmark benchmark, int processes) {
+  switch (benchmark) {
+    case CommBenchmark::kPingPong:
+    case CommBenchmark::kSendrecv:
+    case CommBenchmark::kHypercube:
+      return processes > 1;
+    case CommBenchmark::kBcast:
+    case CommBenchmark::kScatterv:
+    case CommBenchmark::kGatherv:
+    case CommBenchmark::kAllreduce:
+    case CommBenchmark::kAllgatherv:
+      return processes > 0;
+  }
+  return false;
+}
+
+ppc::performance::CommBenchResult ppc::performance::RunCommBenchmark(CommBenchmark benchmark, std::size_t bytes,
+                                                                     MPI_Comm comm) {
+  int rank = 0;
+  int processes = 1;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &processes);
+  if (!IsCommBenchmarkApplicable(benchmark, processes)) {
+    const std::string name(kCommBenchmarkNames[static_cast<std::size_t>(benchmark)]);
+    throw std::invalid_argument("Benchmark " + name + " needs more than " + std::to_string(processes) + " processes");
+  }
+
+  const int count = ToCount(bytes);
+  std::vector<unsigned char> send(bytes, 1);
+  std::vector<unsigned char> recv(bytes);
+  const auto partition = PartitionBytes(bytes, processes);
+  const int local_count = partition.counts[static_cast<std::size_t>(rank)];
+  const int right = (rank + 1) % processes;
+  const int left = (rank + processes - 1) % processes;
+  const int cube_size = static_cast<int>(std::bit_floor(static_cast<unsigned>(processes)));
+  const int dimensions = std::countr_zero(static_cast<unsigned>(cube_size));
+
+  std::function<void()> operation;
+  switch (benchmark) {
+    case CommBenchmark::kPingPong:
+      operation = [&] {
+        if (rank == 0) {
+          MPI_Send(send.data(), count, MPI_BYTE, 1, kBenchTag, comm);
+          MPI_Recv(recv.data(), count, MPI_BYTE, 1, kBenchTag, comm, MPI_STATUS_IGNORE);
+        } else if (rank == 1) {
+          MPI_Recv(recv.data(), count, MPI_BYTE, 0, kBenchTag, comm, MPI_STATUS_IGNORE);
+          MPI_Send(send.data(), count, MPI_BYTE, 0, kBenchTag, comm);
+        }
+      };
+      break;
+    case CommBenchmark::kBcast:
+      operation = [&] { MPI_Bcast(send.data(), count, MPI_BYTE, 0, comm); };
+      break;
+    case CommBenchmark::kScatterv:
+      operation = [&] {
+        MPI_Scatterv(send.data(), partition.counts.data(), partition.displs.data(), MPI_BYTE, recv.data(),
+                     local_count, MPI_BYTE, 0, comm);
+      };
+      break;
+    case CommBenchmark::kGatherv:
+      operation = [&] {
+        MPI_Gatherv(send.data(), local_count, MPI_BYTE, recv.data(), partition.counts.data(),
+                    partition.displs.data(), MPI_BYTE, 0, comm);
+      };
+      break;
+    case CommBenchmark::kAllreduce:
+      operation = [&] { MPI_Allreduce(send.data(), recv.data(), count, MPI_UNSIGNED_CHAR, MPI_SUM, comm); };
+      break;
+    case CommBenchmark::kAllgatherv:
+      operation = [&] {
+        MPI_Allgatherv(send.data(), local_count, MPI_BYTE, recv.data(), partition.counts.data(),
+                       partition.displs.data(), MPI_BYTE, comm);
+      };
+      break;
+    case CommBenchmark::kSendrecv:
+      operation = [&] {
+        MPI_Sendrecv(send.data(), count, MPI_BYTE, right, kBenchTag, recv.data(), count, MPI_BYTE, left, kBenchTag,
+                     comm, MPI_STATUS_IGNORE);
+      };
+      break;
+    case CommBenchmark::kHypercube:
+      operation = [&] {
+        if (rank >= cube_size) {
+          return;
+        }
+        for (int dimension = 0; dimension < dimensions; dimension++) {
+          const int partner = rank ^ (1 << dimension);
+          MPI_Sendrecv(send.data(), count, MPI_BYTE, partner, kBenchTag, recv.data(), count, MPI_BYTE, partner,
+                       kBenchTag, comm, MPI_STATUS_IGNORE);
+        }
+      };
+      break;
+  }
+
+  CommBenchResult result;
+  result.benchmark = benchmark;
+  result.bytes = bytes;
+  result.processes = processes;
+  result.iterations = CommBenchIterations(bytes);
+  result.time_sec = TimeOperation(operation, result.iterations, comm);
+  double moved_bytes = static_cast<double>(bytes);
+  if (benchmark == CommBenchmark::kPingPong) {
+    result.time_sec /= 2.0;
+  } else if (benchmark == CommBenchmark::kHypercube) {
+    moved_bytes *= static_cast<double>(dimensions);
+  }
+  result.bandwidth_bytes_per_sec = (result.time_sec > 0.0) ? moved_bytes / result.time_sec : 0.0;
+  return result;
+}
+
+std::vector<ppc::performance::CommBenchResult> ppc::performance::RunCommBenchSuite(MPI_Comm comm,
+                                                                                   std::size_t max_bytes) {
+  int processes = 1;
+  MPI_Comm_size(comm, &processes);
+  const auto sizes = CommBenchSizes(max_bytes);
+  std::vector<CommBenchResult> results;
+  for (std::size_t index = 0; index < kNumCommBenchmarks; index++) {
+    const auto benchmark = static_cast<CommBenchmark>(index);
+    if (!IsCommBenchmarkApplicable(benchmark, processes)) {
+      continue;
+    }
+    for (const auto bytes : sizes) {
+      results.push_back(RunCommBenchmark(benchmark, bytes, comm));
+    }
+  }
+  return results;
+}
+
+nlohmann::ordered_json ppc::performance::MakeCommBenchRecord(const CommBenchResult &result) {
+  nlohmann::ordered_json record;
+  record["benchmark"] = std::string(kCommBenchmarkNames[static_cast<std::size_t>(result.benchmark)]);
+  record["bytes"] = result.bytes;
+  record["processes"] = result.processes;
+  record["iterations"] = result.iterations;
+  record["time_sec"] = result.time_sec;
+  record["bandwidth_gbs"] = result.bandwidth_bytes_per_sec / 1e9;
+  record["hostname"] = ppc::util::GetHostName();
+  record["git_revision"] = ppc::util::GetGitRevision();
+  return record;
+}
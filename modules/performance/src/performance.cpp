@@ -0,0 +1,640 @@
+#include "performance/include/performance.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "task/include/task.hpp"
+#include "util/include/alloc_tracker.hpp"
+#include "util/include/mpi_profiler.hpp"
+#include "util/include/util.hpp"
+
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+#ifdef __linux__
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#endif
+
+namespace {
+
+// Linear interpolation between the closest ranks of already sorted samples
+double SortedPercentile(const std::vector<double> &sorted, double q) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  const double pos = std::clamp(q, 0.0, 1.0) * static_cast<double>(sorted.size() - 1);
+  const auto lower = static_cast<std::size_t>(std::floor(pos));
+  const auto upper = std::min(lower + 1, sorted.size() - 1);
+  const double frac = pos - static_cast<double>(lower);
+  return sorted[lower] + (frac * (sorted[upper] - sorted[lower]));
+}
+
+// Test ids look like "<namespace>_<backend>_<status>"; the namespace identifies the task
+std::string TaskNameFromTestId(const std::string &test_id, const std::string &backend) {
+  const auto pos = test_id.rfind("_" + backend + "_");
+  return (pos != std::string::npos) ? test_id.substr(0, pos) : test_id;
+}
+
+std::string CsvField(const nlohmann::ordered_json &value) {
+  if (value.is_null()) {
+    return "";
+  }
+  if (!value.is_string()) {
+    return value.dump();
+  }
+  const auto text = value.get<std::string>();
+  if (text.find_first_of(",\"\n") == std::string::npos) {
+    return text;
+  }
+  std::string quoted = "\"";
+  for (char ch : text) {
+    if (ch == '"') {
+      quoted += '"';
+    }
+    quoted += ch;
+  }
+  return quoted + '"';
+}
+
+std::string CsvLine(const nlohmann::ordered_json &record, bool header) {
+  std::string line;
+  for (const auto &[key, value] : record.items()) {
+    if (!line.empty()) {
+      line += ',';
+    }
+    line += header ? key : CsvField(value);
+  }
+  return line + '\n';
+}
+
+// Parses sysfs cache sizes such as "32768K" or "8M"
+std::size_t ParseCacheSize(const std::string &text) {
+  std::size_t pos = 0;
+  std::size_t value = 0;
+  try {
+    value = std::stoull(text, &pos);
+  } catch (const std::exception &) {
+    return 0;
+  }
+  const char unit = (pos < text.size()) ? text[pos] : ' ';
+  if (unit == 'K' || unit == 'k') {
+    return value << 10;
+  }
+  if (unit == 'M' || unit == 'm') {
+    return value << 20;
+  }
+  return value;
+}
+
+#ifdef __linux__
+// Opens one disabled counter of the thread and the threads it creates later
+int OpenPerfEvent(uint32_t type, uint64_t config, pid_t tid) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+// Threads of the calling process, e.g. the main thread and the OpenMP, TBB and pool workers started by the runner
+std::vector<pid_t> ProcessThreadIds() {
+  std::vector<pid_t> tids;
+  std::error_code ec;
+  for (const auto &entry : std::filesystem::directory_iterator("/proc/self/task", ec)) {
+    try {
+      tids.push_back(static_cast<pid_t>(std::stol(entry.path().filename().string())));
+    } catch (const std::exception &) {
+      continue;
+    }
+  }
+  if (tids.empty()) {
+    tids.push_back(static_cast<pid_t>(syscall(SYS_gettid)));
+  }
+  return tids;
+}
+#endif
+
+}  // namespace
+
+double ppc::performance::Percentile(std::vector<double> samples, double q) {
+  std::ranges::sort(samples);
+  return SortedPercentile(samples, q);
+}
+
+ppc::performance::PerfStatistics ppc::performance::ComputePerfStatistics(const std::vector<double> &samples,
+                                                                         double confidence_level,
+                                                                         uint64_t bootstrap_resamples) {
+  PerfStatistics stats;
+  if (samples.empty()) {
+    return stats;
+  }
+
+  std::vector<double> sorted = samples;
+  std::ranges::sort(sorted);
+  const auto n = static_cast<double>(sorted.size());
+
+  stats.min = sorted.front();
+  stats.median = SortedPercentile(sorted, 0.5);
+  stats.p95 = SortedPercentile(sorted, 0.95);
+  stats.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / n;
+  if (sorted.size() > 1) {
+    double sq_sum = 0.0;
+    for (double value : sorted) {
+      sq_sum += (value - stats.mean) * (value - stats.mean);
+    }
+    stats.stddev = std::sqrt(sq_sum / (n - 1.0));
+  }
+
+  stats.ci_low = stats.median;
+  stats.ci_high = stats.median;
+  if (sorted.size() < 2 || bootstrap_resamples == 0) {
+    return stats;
+  }
+
+  // Percentile bootstrap of the median; a fixed seed keeps reports reproducible
+  std::mt19937_64 gen(sorted.size());
+  std::uniform_int_distribution<std::size_t> pick(0, sorted.size() - 1);
+  std::vector<double> resample(sorted.size());
+  std::vector<double> medians;
+  medians.reserve(bootstrap_resamples);
+  for (uint64_t i = 0; i < bootstrap_resamples; i++) {
+    for (double &value : resample) {
+      value = sorted[pick(gen)];
+    }
+    std::ranges::sort(resample);
+    medians.push_back(SortedPercentile(resample, 0.5));
+  }
+  std::ranges::sort(medians);
+  const double alpha = 1.0 - std::clamp(confidence_level, 0.0, 1.0);
+  stats.ci_low = SortedPercentile(medians, alpha / 2.0);
+  stats.ci_high = SortedPercentile(medians, 1.0 - (alpha / 2.0));
+  return stats;
+}
+
+ppc::performance::RankStatistics ppc::performance::ComputeRankStatistics(const std::vector<double> &values) {
+  RankStatistics stats;
+  if (values.empty()) {
+    return stats;
+  }
+  const auto [min_it, max_it] = std::ranges::minmax_element(values);
+  stats.min = *min_it;
+  stats.max = *max_it;
+  stats.mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+  stats.imbalance = (stats.mean > 0.0) ? stats.max / stats.mean : 1.0;
+  return stats;
+}
+
+std::map<std::string, ppc::performance::MpiCallTotals> ppc::performance::SummarizeMpiProfile(
+    const std::vector<ppc::util::MpiProfileEntry> &profile, std::string_view stage) {
+  std::map<std::string, MpiCallTotals> summary;
+  for (const auto &entry : profile) {
+    if (entry.stage != stage) {
+      continue;
+    }
+    auto &totals = summary[entry.function];
+    totals.calls += entry.calls;
+    totals.bytes += entry.bytes;
+    totals.time_sec += entry.time_sec;
+  }
+  return summary;
+}
+
+std::vector<double> ppc::performance::CommunicationRow(const std::vector<ppc::util::MpiProfileEntry> &profile,
+                                                       std::string_view stage, int num_ranks) {
+  std::vector<double> row(static_cast<std::size_t>(std::max(num_ranks, 0)), 0.0);
+  for (const auto &entry : profile) {
+    if (entry.stage == stage && entry.sends && entry.peer >= 0 && entry.peer < num_ranks) {
+      row[static_cast<std::size_t>(entry.peer)] += static_cast<double>(entry.bytes);
+    }
+  }
+  return row;
+}
+
+nlohmann::ordered_json ppc::performance::MakePerfRecord(const PerfResults &results, const std::string &test_id,
+                                                        const std::string &backend, const std::string &mode) {
+  const auto &stats = results.statistics;
+  const auto &stages = results.stage_stats;
+  const auto &ranks = results.rank_report;
+  nlohmann::ordered_json record;
+  record["test_id"] = test_id;
+  record["task"] = TaskNameFromTestId(test_id, backend);
+  record["backend"] = backend;
+  record["mode"] = mode;
+  record["status"] = (results.time_sec < ppc::util::GetPerfMaxTime()) ? "ok" : "time_limit_exceeded";
+  record["processes"] = ranks.num_ranks;
+  record["threads"] = ppc::util::GetNumThreads();
+  record["input_size"] = results.input_size;
+  record["time_sec"] = results.time_sec;
+  record["samples"] = results.samples.size();
+  record["min_sec"] = stats.min;
+  record["median_sec"] = stats.median;
+  record["mean_sec"] = stats.mean;
+  record["p95_sec"] = stats.p95;
+  record["stddev_sec"] = stats.stddev;
+  record["ci_low_sec"] = stats.ci_low;
+  record["ci_high_sec"] = stats.ci_high;
+  record["validation_sec"] = stages.validation.MeanSec();
+  record["pre_processing_sec"] = stages.pre_processing.MeanSec();
+  record["run_sec"] = stages.run.MeanSec();
+  record["post_processing_sec"] = stages.post_processing.MeanSec();
+  const std::array<std::pair<const char *, const ppc::task::StageStats *>, 4> stage_list = {{
+      {"validation", &stages.validation},
+      {"pre_processing", &stages.pre_processing},
+      {"run", &stages.run},
+      {"post_processing", &stages.post_processing},
+  }};
+  for (const auto &[name, stage] : stage_list) {
+    const std::string key = name;
+    if (ppc::util::IsAllocationTrackingEnabled() && stage->calls != 0) {
+      const auto calls = static_cast<double>(stage->calls);
+      record[key + "_allocations"] = static_cast<double>(stage->allocations) / calls;
+      record[key + "_allocated_bytes"] = static_cast<double>(stage->allocated_bytes) / calls;
+      record[key + "_peak_heap_bytes"] = stage->peak_heap_bytes;
+    } else {
+      record[key + "_allocations"] = nullptr;
+      record[key + "_allocated_bytes"] = nullptr;
+      record[key + "_peak_heap_bytes"] = nullptr;
+    }
+  }
+  record["peak_rss_bytes"] = results.peak_rss_bytes;
+  const auto &roofline = results.roofline;
+  record["bandwidth_gbs"] =
+      roofline.has_value() ? nlohmann::ordered_json(roofline->bandwidth_bytes_per_sec / 1e9) : nlohmann::ordered_json();
+  record["gflops"] =
+      roofline.has_value() ? nlohmann::ordered_json(roofline->flops_per_sec / 1e9) : nlohmann::ordered_json();
+  record["percent_of_roofline"] =
+      roofline.has_value() ? nlohmann::ordered_json(roofline->percent_of_roofline) : nlohmann::ordered_json();
+  if (ppc::util::IsMpiProfilingEnabled() && stages.run.calls != 0) {
+    MpiCallTotals run_totals;
+    for (const auto &[function, totals] : SummarizeMpiProfile(results.mpi_profile, "run")) {
+      run_totals.calls += totals.calls;
+      run_totals.bytes += totals.bytes;
+      run_totals.time_sec += totals.time_sec;
+    }
+    const auto calls = static_cast<double>(stages.run.calls);
+    record["mpi_run_calls"] = static_cast<double>(run_totals.calls) / calls;
+    record["mpi_run_bytes"] = static_cast<double>(run_totals.bytes) / calls;
+    record["mpi_run_time_sec"] = run_totals.time_sec / calls;
+  } else {
+    record["mpi_run_calls"] = nullptr;
+    record["mpi_run_bytes"] = nullptr;
+    record["mpi_run_time_sec"] = nullptr;
+  }
+  record["cold_median_sec"] = results.cold_statistics.median;
+  record["cold_mean_sec"] = results.cold_statistics.mean;
+  for (std::size_t counter = 0; counter < results.counters.size(); counter++) {
+    const auto &value = results.counters[counter];
+    record[std::string(kHardwareCounterNames[counter])] =
+        value.has_value() ? nlohmann::ordered_json(*value) : nlohmann::ordered_json();
+  }
+  const auto ipc = InstructionsPerCycle(results.counters);
+  record["ipc"] = ipc.has_value() ? nlohmann::ordered_json(*ipc) : nlohmann::ordered_json();
+  record["rank_min_sec"] = ranks.time.min;
+  record["rank_max_sec"] = ranks.time.max;
+  record["rank_mean_sec"] = ranks.time.mean;
+  record["rank_imbalance"] = ranks.time.imbalance;
+  record["hostname"] = ppc::util::GetHostName();
+  record["git_revision"] = ppc::util::GetGitRevision();
+  return record;
+}
+
+void ppc::performance::WritePerfRecord(const nlohmann::ordered_json &record, const std::string &output_dir,
+                                       const std::string &format, const std::string &file_stem) {
+  if (format != "jsonl" && format != "csv") {
+    throw std::runtime_error("Unknown perf output format: " + format);
+  }
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::create_directories(output_dir, ec);
+  const fs::path path = fs::path(output_dir) / (file_stem + "." + format);
+
+  std::string text;
+  if (format == "jsonl") {
+    text = record.dump() + '\n';
+  } else {
+    if (!fs::exists(path, ec) || fs::file_size(path, ec) == 0) {
+      text = CsvLine(record, true);
+    }
+    text += CsvLine(record, false);
+  }
+
+  // Single write per record so that concurrent test binaries do not interleave lines
+  std::ofstream file(path, std::ios::app | std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open " + path.string());
+  }
+  file << text;
+  if (!file) {
+    throw std::runtime_error("Failed to write " + path.string());
+  }
+}
+
+double ppc::performance::MannWhitneyGreaterPValue(const std::vector<double> &current,
+                                                  const std::vector<double> &baseline) {
+  if (current.empty() || baseline.empty()) {
+    return 1.0;
+  }
+  double u = 0.0;
+  for (double x : current) {
+    for (double y : baseline) {
+      if (x > y) {
+        u += 1.0;
+      } else if (x == y) {
+        u += 0.5;
+      }
+    }
+  }
+  const auto n1 = static_cast<double>(current.size());
+  const auto n2 = static_cast<double>(baseline.size());
+  const double mean = n1 * n2 / 2.0;
+  const double sigma = std::sqrt(n1 * n2 * (n1 + n2 + 1.0) / 12.0);
+  // Continuity-corrected normal approximation of the upper tail
+  const double z = (u - mean - 0.5) / sigma;
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+ppc::performance::RegressionCheck ppc::performance::CheckRegression(const PerfBaseline &baseline,
+                                                                    const PerfResults &results, double threshold,
+                                                                    double significance) {
+  RegressionCheck check;
+  if (baseline.median_sec <= 0.0) {
+    return check;
+  }
+  check.ratio = results.time_sec / baseline.median_sec;
+  check.p_value = baseline.samples.empty() ? 0.0 : MannWhitneyGreaterPValue(results.samples, baseline.samples);
+  check.regressed = check.ratio > 1.0 + threshold && check.p_value < significance;
+  return check;
+}
+
+std::optional<ppc::performance::PerfBaseline> ppc::performance::LoadPerfBaseline(const std::string &path,
+                                                                                 const std::string &test_id,
+                                                                                 const std::string &mode) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  const auto baselines = nlohmann::json::parse(file, nullptr, false);
+  if (baselines.is_discarded() || !baselines.is_object()) {
+    throw std::runtime_error("Failed to parse perf baseline file " + path);
+  }
+  if (!baselines.contains(test_id) || !baselines[test_id].contains(mode)) {
+    return std::nullopt;
+  }
+  const auto &entry = baselines[test_id][mode];
+  PerfBaseline baseline;
+  baseline.median_sec = entry.value("median_sec", 0.0);
+  baseline.samples = entry.value("samples", std::vector<double>{});
+  return baseline;
+}
+
+void ppc::performance::StorePerfBaseline(const std::string &path, const std::string &test_id, const std::string &mode,
+                                         const PerfResults &results) {
+  nlohmann::json baselines = nlohmann::json::object();
+  {
+    std::ifstream file(path);
+    if (file.is_open()) {
+      auto existing = nlohmann::json::parse(file, nullptr, false);
+      if (!existing.is_discarded() && existing.is_object()) {
+        baselines = std::move(existing);
+      }
+    }
+  }
+  baselines[test_id][mode] = {
+      {"median_sec", results.time_sec},
+      {"samples", results.samples},
+      {"hostname", ppc::util::GetHostName()},
+      {"git_revision", ppc::util::GetGitRevision()},
+  };
+
+  const auto parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) {
+    std::error_code ec;
+    std::filesystem::create_directories(parent, ec);
+  }
+  std::ofstream file(path, std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  file << baselines.dump(2) << '\n';
+  if (!file) {
+    throw std::runtime_error("Failed to write " + path);
+  }
+}
+
+std::vector<int> ppc::performance::ThreadSweepCounts(int max_threads) {
+  std::vector<int> counts = {1};
+  for (int num_threads = 2; num_threads < max_threads; num_threads *= 2) {
+    counts.push_back(num_threads);
+  }
+  if (max_threads > 1) {
+    counts.push_back(max_threads);
+  }
+  return counts;
+}
+
+std::vector<std::size_t> ppc::performance::SizeLadder(std::size_t max_size, std::size_t num_sizes) {
+  std::vector<std::size_t> sizes;
+  for (std::size_t size = max_size; size > 0 && sizes.size() < num_sizes; size /= 2) {
+    sizes.push_back(size);
+  }
+  std::ranges::reverse(sizes);
+  return sizes;
+}
+
+ppc::performance::ComplexityFit ppc::performance::FitComplexity(const std::vector<double> &sizes,
+                                                                const std::vector<double> &times) {
+  std::vector<double> log_sizes;
+  std::vector<double> log_times;
+  for (std::size_t i = 0; i < std::min(sizes.size(), times.size()); i++) {
+    if (sizes[i] > 0.0 && times[i] > 0.0) {
+      log_sizes.push_back(std::log(sizes[i]));
+      log_times.push_back(std::log(times[i]));
+    }
+  }
+  ComplexityFit fit;
+  if (log_sizes.size() < 2) {
+    return fit;
+  }
+  const auto n = static_cast<double>(log_sizes.size());
+  const double mean_x = std::accumulate(log_sizes.begin(), log_sizes.end(), 0.0) / n;
+  const double mean_y = std::accumulate(log_times.begin(), log_times.end(), 0.0) / n;
+  double sxx = 0.0;
+  double sxy = 0.0;
+  double syy = 0.0;
+  for (std::size_t i = 0; i < log_sizes.size(); i++) {
+    sxx += (log_sizes[i] - mean_x) * (log_sizes[i] - mean_x);
+    sxy += (log_sizes[i] - mean_x) * (log_times[i] - mean_y);
+    syy += (log_times[i] - mean_y) * (log_times[i] - mean_y);
+  }
+  if (sxx <= 0.0) {
+    return fit;
+  }
+  fit.exponent = sxy / sxx;
+  fit.coefficient = std::exp(mean_y - (fit.exponent * mean_x));
+  fit.r_squared = (syy > 0.0) ? (sxy * sxy) / (sxx * syy) : 1.0;
+  return fit;
+}
+
+std::size_t ppc::performance::DetectLastLevelCacheBytes() {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  const long l3_bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  if (l3_bytes > 0) {
+    return static_cast<std::size_t>(l3_bytes);
+  }
+#endif
+  // The highest cache index of CPU 0 is the last level
+  std::size_t bytes = 0;
+  for (int index = 0; index < 8; index++) {
+    std::ifstream file("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size");
+    std::string text;
+    if (!(file >> text)) {
+      break;
+    }
+    bytes = ParseCacheSize(text);
+  }
+  return bytes;
+}
+
+void ppc::performance::EvictCaches(std::size_t bytes) {
+  constexpr std::size_t kCacheLine = 64;
+  static std::vector<unsigned char> buffer;
+  if (buffer.size() < bytes) {
+    buffer.resize(bytes);
+  }
+  for (std::size_t i = 0; i < bytes; i += kCacheLine) {
+    buffer[i]++;
+  }
+  unsigned sum = 0;
+  for (std::size_t i = 0; i < bytes; i += kCacheLine) {
+    sum += buffer[i];
+  }
+  // Keep the reads observable so that the loops are not optimized away
+  static volatile unsigned sink = 0;
+  sink = sink + sum;
+}
+
+ppc::performance::HardwareCounters::HardwareCounters() {
+#ifdef __linux__
+  const std::array<std::pair<uint32_t, uint64_t>, kNumHardwareCounters> events = {{
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND},
+  }};
+  const auto tids = ProcessThreadIds();
+  for (std::size_t counter = 0; counter < events.size(); counter++) {
+    auto &fds = fds_[counter];
+    for (pid_t tid : tids) {
+      const int fd = OpenPerfEvent(events[counter].first, events[counter].second, tid);
+      if (fd >= 0) {
+        fds.push_back(fd);
+      } else if (errno != ESRCH) {
+        // A counter missing on one thread would undercount; drop it everywhere. Threads that exited are skipped
+        CloseAll(fds);
+        break;
+      }
+    }
+  }
+#endif
+}
+
+ppc::performance::HardwareCounters::~HardwareCounters() {
+  for (auto &fds : fds_) {
+    CloseAll(fds);
+  }
+}
+
+void ppc::performance::HardwareCounters::CloseAll(std::vector<int> &fds) {
+#ifndef _WIN32
+  for (int fd : fds) {
+    close(fd);
+  }
+#endif
+  fds.clear();
+}
+
+bool ppc::performance::HardwareCounters::Available() const {
+  return std::ranges::any_of(fds_, [](const auto &fds) { return !fds.empty(); });
+}
+
+void ppc::performance::HardwareCounters::Start() {
+#ifdef __linux__
+  for (const auto &fds : fds_) {
+    for (int fd : fds) {
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+#endif
+}
+
+void ppc::performance::HardwareCounters::Stop() {
+#ifdef __linux__
+  for (const auto &fds : fds_) {
+    for (int fd : fds) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+#endif
+}
+
+ppc::performance::HardwareCounterValues ppc::performance::HardwareCounters::Read() const {
+  HardwareCounterValues values{};
+#ifdef __linux__
+  for (std::size_t counter = 0; counter < fds_.size(); counter++) {
+    if (fds_[counter].empty()) {
+      continue;
+    }
+    double total = 0.0;
+    for (int fd : fds_[counter]) {
+      // value, time enabled, time running
+      std::array<uint64_t, 3> data{};
+      if (read(fd, data.data(), sizeof(data)) != sizeof(data)) {
+        continue;
+      }
+      double value = static_cast<double>(data[0]);
+      if (data[2] != 0 && data[2] < data[1]) {
+        // The counter shared the PMU with others; extrapolate to the whole enabled time
+        value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+      }
+      total += value;
+    }
+    values[counter] = total;
+  }
+#endif
+  return values;
+}
+
+std::optional<double> ppc::performance::InstructionsPerCycle(const HardwareCounterValues &counters) {
+  const auto &cycles = counters[static_cast<std::size_t>(HardwareCounter::kCycles)];
+  const auto &instructions = counters[static_cast<std::size_t>(HardwareCounter::kInstructions)];
+  if (!cycles.has_value() || !instructions.has_value() || *cycles <= 0.0) {
+    return std::nullopt;
+  }
+  return *instructions / *cycles;
+}
@@ -0,0 +1,141 @@
+#include "performance/include/roofline.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "performance/include/performance.hpp"
+
+namespace {
+
+constexpr int kProbeRepetitions = 5;
+constexpr std::size_t kMinStreamArrayBytes = std::size_t{32} << 20;
+constexpr std::size_t kMaxStreamArrayBytes = std::size_t{256} << 20;
+// Enough independent chains to hide the latency of the multiply-add units
+constexpr std::size_t kFlopChains = 32;
+constexpr uint64_t kFlopIterations = uint64_t{1} << 22;
+
+double RunMultiplyAddChains(uint64_t iterations) {
+  std::array<double, kFlopChains> chains{};
+  for (std::size_t chain = 0; chain < kFlopChains; chain++) {
+    chains[chain] = 1.0 + (static_cast<double>(chain) * 1e-3);
+  }
+  // The factors keep the values bounded, so no iteration runs into denormals or infinities
+  const double multiplier = 0.999999;
+  const double addend = 1e-6;
+  for (uint64_t i = 0; i < iterations; i++) {
+    for (auto &value : chains) {
+      value = (value * multiplier) + addend;
+    }
+  }
+  double sum = 0.0;
+  for (const double value : chains) {
+    sum += value;
+  }
+  return sum;
+}
+
+}  // namespace
+
+double ppc::performance::MeasureStreamBandwidth(std::size_t array_bytes, int num_threads) {
+  const auto size = static_cast<std::int64_t>(std::max<std::size_t>(array_bytes / sizeof(double), 1));
+  const auto a = std::make_unique_for_overwrite<double[]>(static_cast<std::size_t>(size));
+  const auto b = std::make_unique_for_overwrite<double[]>(static_cast<std::size_t>(size));
+  const auto c = std::make_unique_for_overwrite<double[]>(static_cast<std::size_t>(size));
+  // First touch with the same schedule as the kernel places the pages next to the threads that use them
+#pragma omp parallel for default(none) shared(a, b, c, size) num_threads(num_threads) schedule(static)
+  for (std::int64_t i = 0; i < size; i++) {
+    a[i] = 0.0;
+    b[i] = 1.0;
+    c[i] = 2.0;
+  }
+
+  const double scalar = 3.0;
+  double best_sec = std::numeric_limits<double>::max();
+  for (int repetition = 0; repetition < kProbeRepetitions; repetition++) {
+    const double begin = omp_get_wtime();
+#pragma omp parallel for default(none) shared(a, b, c, size, scalar) num_threads(num_threads) schedule(static)
+    for (std::int64_t i = 0; i < size; i++) {
+      a[i] = b[i] + (scalar * c[i]);
+    }
+    best_sec = std::min(best_sec, omp_get_wtime() - begin);
+  }
+  const double bytes = 3.0 * sizeof(double) * static_cast<double>(size);
+  return (best_sec > 0.0) ? bytes / best_sec : 0.0;
+}
+
+double ppc::performance::MeasurePeakFlops(int num_threads) {
+  double best_sec = std::numeric_limits<double>::max();
+  double sink = 0.0;
+  for (int repetition = 0; repetition < kProbeRepetitions; repetition++) {
+    const double begin = omp_get_wtime();
+#pragma omp parallel default(none) num_threads(num_threads) reduction(+ : sink)
+    sink += RunMultiplyAddChains(kFlopIterations);
+    best_sec = std::min(best_sec, omp_get_wtime() - begin);
+  }
+  // Using the result keeps the compiler from dropping the kernel
+  if (sink == 0.0) {
+    return 0.0;
+  }
+  const double flops = 2.0 * static_cast<double>(kFlopChains) * static_cast<double>(kFlopIterations) *
+                       static_cast<double>(num_threads);
+  return (best_sec > 0.0) ? flops / best_sec : 0.0;
+}
+
+std::size_t ppc::performance::StreamArrayBytes(std::size_t last_level_cache_bytes, int ranks_per_node) {
+  const std::size_t node_bytes = std::clamp(4 * last_level_cache_bytes, kMinStreamArrayBytes, kMaxStreamArrayBytes);
+  return node_bytes / static_cast<std::size_t>(std::max(ranks_per_node, 1));
+}
+
+ppc::performance::MachinePeaks ppc::performance::GetMachinePeaks(int num_threads, int ranks_per_node) {
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>, MachinePeaks> cache;
+  const std::scoped_lock lock(mutex);
+  const auto key = std::make_pair(num_threads, ranks_per_node);
+  const auto cached = cache.find(key);
+  if (cached != cache.end()) {
+    return cached->second;
+  }
+  MachinePeaks peaks;
+  peaks.bandwidth_bytes_per_sec =
+      MeasureStreamBandwidth(StreamArrayBytes(DetectLastLevelCacheBytes(), ranks_per_node), num_threads);
+  peaks.flops_per_sec = MeasurePeakFlops(num_threads);
+  cache.emplace(key, peaks);
+  return peaks;
+}
+
+ppc::performance::RooflineReport ppc::performance::ComputeRoofline(uint64_t bytes, uint64_t flops, double time_sec,
+                                                                   const MachinePeaks &peaks) {
+  RooflineReport report;
+  report.peaks = peaks;
+  if (time_sec <= 0.0) {
+    return report;
+  }
+  report.bandwidth_bytes_per_sec = static_cast<double>(bytes) / time_sec;
+  report.flops_per_sec = static_cast<double>(flops) / time_sec;
+  if (bytes != 0 && flops != 0) {
+    report.arithmetic_intensity = static_cast<double>(flops) / static_cast<double>(bytes);
+  }
+  double roof = 0.0;
+  double achieved = 0.0;
+  if (flops != 0) {
+    roof = peaks.flops_per_sec;
+    if (bytes != 0) {
+      roof = std::min(roof, report.arithmetic_intensity * peaks.bandwidth_bytes_per_sec);
+    }
+    achieved = report.flops_per_sec;
+  } else {
+    roof = peaks.bandwidth_bytes_per_sec;
+    achieved = report.bandwidth_bytes_per_sec;
+  }
+  report.percent_of_roofline = (roof > 0.0) ? 100.0 * achieved / roof : 0.0;
+  return report;
+}
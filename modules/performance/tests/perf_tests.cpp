@@ -1,18 +1,26 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <libenvpp/detail/environment.hpp>
 #include <memory>
 #include <ostream>
+#include <random>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "performance/include/comm_bench.hpp"
 #include "performance/include/performance.hpp"
+#include "performance/include/roofline.hpp"
 #include "task/include/task.hpp"
 #include "util/include/util.hpp"
 
@@ -371,6 +379,775 @@ TEST(PerfTest, PipelineRunAndTaskRun) {
   EXPECT_GT(res_taskrun.time_sec, 0.0);
 }
 
+TEST(PerfTest, PipelineRunCollectsStageStats) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_running = 3;
+  perf.PipelineRun(attr);
+
+  const auto &stats = perf.GetPerfResults().stage_stats;
+  EXPECT_EQ(stats.validation.calls, 3U);
+  EXPECT_EQ(stats.pre_processing.calls, 3U);
+  EXPECT_EQ(stats.run.calls, 3U);
+  EXPECT_EQ(stats.post_processing.calls, 3U);
+}
+
+TEST(PerfTest, TaskRunCollectsStageStatsOfMeasuredRunOnly) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_running = 4;
+  perf.TaskRun(attr);
+
+  const auto &stats = perf.GetPerfResults().stage_stats;
+  EXPECT_EQ(stats.validation.calls, 1U);
+  EXPECT_EQ(stats.pre_processing.calls, 1U);
+  EXPECT_EQ(stats.run.calls, 4U);
+  EXPECT_EQ(stats.post_processing.calls, 1U);
+}
+
+TEST(PerfTest, PrintPerfStatisticReportsStages) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_running = 1;
+  perf.PipelineRun(attr);
+
+  ::testing::internal::CaptureStdout();
+  perf.PrintPerfStatistic("stage_test");
+  const std::string output = ::testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("stage_test:pipeline:validation:"), std::string::npos);
+  EXPECT_NE(output.find("stage_test:pipeline:pre_processing:"), std::string::npos);
+  EXPECT_NE(output.find("stage_test:pipeline:run:"), std::string::npos);
+  EXPECT_NE(output.find("stage_test:pipeline:post_processing:"), std::string::npos);
+}
+
+TEST(PerfTest, CommonRunStoresPerIterationSamples) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  double time = 0.0;
+  double step = 1.0;
+  attr.num_running = 4;
+  attr.current_timer = [&time, &step]() {
+    double t = time;
+    time += step;
+    step += 1.0;
+    return t;
+  };
+  perf.PipelineRun(attr);
+
+  const auto res = perf.GetPerfResults();
+  ASSERT_EQ(res.samples.size(), 4U);
+  EXPECT_DOUBLE_EQ(res.samples[0], 2.0);
+  EXPECT_DOUBLE_EQ(res.samples[3], 8.0);
+  EXPECT_DOUBLE_EQ(res.statistics.min, 2.0);
+  EXPECT_DOUBLE_EQ(res.statistics.median, 5.0);
+  EXPECT_DOUBLE_EQ(res.time_sec, res.statistics.median);
+}
+
+TEST(PerfTest, WarmupIterationsAreNotMeasured) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  attr.num_warmup = 2;
+  attr.num_running = 3;
+  perf.PipelineRun(attr);
+
+  const auto res = perf.GetPerfResults();
+  EXPECT_EQ(res.samples.size(), 3U);
+  EXPECT_EQ(res.stage_stats.run.calls, 3U);
+
+  perf.TaskRun(attr);
+  const auto res_task = perf.GetPerfResults();
+  EXPECT_EQ(res_task.samples.size(), 3U);
+  EXPECT_EQ(res_task.stage_stats.run.calls, 3U);
+  EXPECT_EQ(res_task.stage_stats.validation.calls, 1U);
+}
+
+TEST(PerfTest, AdaptiveModeStopsAtMaxRunning) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  double time = 0.0;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> step(1.0, 2.0);
+  attr.num_running = 5;
+  attr.adaptive = true;
+  attr.target_relative_ci = 0.0;
+  attr.max_running = 23;
+  attr.time_budget_sec = 1e9;
+  attr.bootstrap_resamples = 50;
+  // Random iteration times never give a zero-width interval
+  attr.current_timer = [&]() {
+    time += step(gen);
+    return time;
+  };
+  perf.PipelineRun(attr);
+  EXPECT_EQ(perf.GetPerfResults().samples.size(), 23U);
+}
+
+TEST(PerfTest, AdaptiveModeStopsWhenIntervalIsTight) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  double time = 0.0;
+  attr.num_running = 5;
+  attr.adaptive = true;
+  attr.max_running = 100;
+  attr.current_timer = [&time]() {
+    time += 1.0;
+    return time;
+  };
+  perf.PipelineRun(attr);
+  EXPECT_EQ(perf.GetPerfResults().samples.size(), 5U);
+}
+
+TEST(PerfStatisticsTest, ComputesSummaryStatistics) {
+  const std::vector<double> samples = {5.0, 1.0, 3.0, 2.0, 4.0, 100.0};
+  const auto stats = ComputePerfStatistics(samples, 0.95, 500);
+  EXPECT_DOUBLE_EQ(stats.min, 1.0);
+  EXPECT_DOUBLE_EQ(stats.median, 3.5);
+  EXPECT_NEAR(stats.mean, 115.0 / 6.0, 1e-12);
+  EXPECT_DOUBLE_EQ(stats.p95, 76.25);
+  EXPECT_GT(stats.stddev, 0.0);
+  EXPECT_LE(stats.ci_low, stats.median);
+  EXPECT_GE(stats.ci_high, stats.median);
+  EXPECT_LT(stats.ci_high, 100.0);
+}
+
+TEST(PerfStatisticsTest, HandlesEmptyAndSingleSample) {
+  const auto empty = ComputePerfStatistics({}, 0.95, 100);
+  EXPECT_DOUBLE_EQ(empty.median, 0.0);
+
+  const auto single = ComputePerfStatistics({2.0}, 0.95, 100);
+  EXPECT_DOUBLE_EQ(single.min, 2.0);
+  EXPECT_DOUBLE_EQ(single.p95, 2.0);
+  EXPECT_DOUBLE_EQ(single.stddev, 0.0);
+  EXPECT_DOUBLE_EQ(single.ci_low, 2.0);
+  EXPECT_DOUBLE_EQ(single.ci_high, 2.0);
+}
+
+TEST(PerfStatisticsTest, PercentileInterpolates) {
+  EXPECT_DOUBLE_EQ(Percentile({4.0, 1.0, 3.0, 2.0}, 0.5), 2.5);
+  EXPECT_DOUBLE_EQ(Percentile({4.0, 1.0, 3.0, 2.0}, 0.0), 1.0);
+  EXPECT_DOUBLE_EQ(Percentile({4.0, 1.0, 3.0, 2.0}, 1.0), 4.0);
+  EXPECT_DOUBLE_EQ(Percentile({}, 0.5), 0.0);
+}
+
+TEST(PerfTest, BarrierIsCalledBeforeEveryMeasuredIteration) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  int barriers = 0;
+  attr.num_running = 4;
+  attr.num_warmup = 2;
+  attr.barrier = [&barriers]() { barriers++; };
+  perf.TaskRun(attr);
+  EXPECT_EQ(barriers, 4);
+}
+
+TEST(PerfTest, AllGatherBuildsRankReport) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  double time = 0.0;
+  attr.num_running = 3;
+  attr.current_timer = [&time]() {
+    time += 1.0;
+    return time;
+  };
+  // Emulate a second rank that is three times slower than this one
+  attr.all_gather = [](const std::vector<double> &local) {
+    std::vector<double> gathered = local;
+    for (double value : local) {
+      gathered.push_back(value * 3.0);
+    }
+    return gathered;
+  };
+  perf.PipelineRun(attr);
+
+  const auto report = perf.GetPerfResults().rank_report;
+  EXPECT_EQ(report.num_ranks, 2);
+  EXPECT_DOUBLE_EQ(report.time.min, 1.0);
+  EXPECT_DOUBLE_EQ(report.time.max, 3.0);
+  EXPECT_DOUBLE_EQ(report.time.mean, 2.0);
+  EXPECT_DOUBLE_EQ(report.time.imbalance, 1.5);
+  EXPECT_DOUBLE_EQ(report.run.max, 3.0 * report.run.min);
+
+  ::testing::internal::CaptureStdout();
+  perf.PrintPerfStatistic("rank_test");
+  const std::string output = ::testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("rank_test:pipeline:time:imbalance:1.5"), std::string::npos);
+  EXPECT_NE(output.find("rank_test:pipeline:run:rank_max:"), std::string::npos);
+}
+
+TEST(PerfTest, AdaptiveModeFollowsOtherRanks) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+
+  PerfAttr attr;
+  double time = 0.0;
+  int votes = 0;
+  attr.num_running = 2;
+  attr.adaptive = true;
+  attr.current_timer = [&time]() {
+    time += 1.0;
+    return time;
+  };
+  // This rank is already tight, the emulated peer asks for two more batches
+  attr.all_gather = [&votes](const std::vector<double> &local) {
+    std::vector<double> gathered = local;
+    if (local.size() == 1) {
+      votes++;
+      gathered.push_back(votes <= 2 ? 1.0 : 0.0);
+    } else {
+      gathered.insert(gathered.end(), local.begin(), local.end());
+    }
+    return gathered;
+  };
+  perf.PipelineRun(attr);
+  EXPECT_EQ(perf.GetPerfResults().samples.size(), 6U);
+}
+
+TEST(PerfStatisticsTest, ComputesRankStatistics) {
+  const auto stats = ComputeRankStatistics({1.0, 2.0, 6.0});
+  EXPECT_DOUBLE_EQ(stats.min, 1.0);
+  EXPECT_DOUBLE_EQ(stats.max, 6.0);
+  EXPECT_DOUBLE_EQ(stats.mean, 3.0);
+  EXPECT_DOUBLE_EQ(stats.imbalance, 2.0);
+  EXPECT_DOUBLE_EQ(ComputeRankStatistics({0.0, 0.0}).imbalance, 1.0);
+}
+
+TEST(PerfRecordTest, EstimatesInputSize) {
+  struct Opaque {
+    int value;
+  };
+  EXPECT_EQ(EstimateInputSize(std::vector<int>(7)), 7U);
+  EXPECT_EQ(EstimateInputSize(std::string("abc")), 3U);
+  EXPECT_EQ(EstimateInputSize(42), 1U);
+  EXPECT_EQ(EstimateInputSize(std::make_pair(std::vector<double>(4), 2)), 5U);
+  EXPECT_EQ(EstimateInputSize(Opaque{1}), 0U);
+}
+
+TEST(PerfRecordTest, ContainsIdentificationAndStatistics) {
+  PerfResults results;
+  results.time_sec = 0.5;
+  results.samples = {0.4, 0.5, 0.6};
+  results.statistics = ComputePerfStatistics(results.samples, 0.95, 100);
+  results.input_size = 100;
+  results.stage_stats.run.Record(0.5);
+
+  const auto record = MakePerfRecord(results, "example_a_sum_mpi_enabled", "mpi", "pipeline");
+  EXPECT_EQ(record["test_id"], "example_a_sum_mpi_enabled");
+  EXPECT_EQ(record["task"], "example_a_sum");
+  EXPECT_EQ(record["backend"], "mpi");
+  EXPECT_EQ(record["mode"], "pipeline");
+  EXPECT_EQ(record["status"], "ok");
+  EXPECT_EQ(record["processes"], 1);
+  EXPECT_EQ(record["input_size"], 100U);
+  EXPECT_EQ(record["samples"], 3U);
+  EXPECT_DOUBLE_EQ(record["median_sec"].get<double>(), 0.5);
+  EXPECT_DOUBLE_EQ(record["run_sec"].get<double>(), 0.5);
+  EXPECT_TRUE(record.contains("threads"));
+  EXPECT_TRUE(record.contains("hostname"));
+  EXPECT_TRUE(record.contains("git_revision"));
+}
+
+TEST(PerfRecordTest, WritesJsonLines) {
+  const auto dir = std::filesystem::temp_directory_path() / "ppc_perf_record_jsonl";
+  std::filesystem::remove_all(dir);
+  const auto record = MakePerfRecord(PerfResults{}, "example_seq_enabled", "seq", "task_run");
+  WritePerfRecord(record, dir.string(), "jsonl");
+  WritePerfRecord(record, dir.string(), "jsonl");
+
+  std::ifstream file(dir / "perf_results.jsonl");
+  std::string line;
+  int lines = 0;
+  while (std::getline(file, line)) {
+    EXPECT_EQ(nlohmann::json::parse(line)["task"], "example");
+    lines++;
+  }
+  EXPECT_EQ(lines, 2);
+  file.close();
+  std::filesystem::remove_all(dir);
+}
+
+TEST(PerfRecordTest, WritesCsvWithSingleHeader) {
+  const auto dir = std::filesystem::temp_directory_path() / "ppc_perf_record_csv";
+  std::filesystem::remove_all(dir);
+  const auto record = MakePerfRecord(PerfResults{}, "example_seq_enabled", "seq", "task_run");
+  WritePerfRecord(record, dir.string(), "csv");
+  WritePerfRecord(record, dir.string(), "csv");
+
+  std::ifstream file(dir / "perf_results.csv");
+  std::vector<std::string> lines;
+  for (std::string line; std::getline(file, line);) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(lines.size(), 3U);
+  EXPECT_TRUE(lines[0].starts_with("test_id,task,backend,mode,"));
+  EXPECT_TRUE(lines[1].starts_with("example_seq_enabled,example,seq,task_run,"));
+  EXPECT_EQ(lines[1], lines[2]);
+  file.close();
+  std::filesystem::remove_all(dir);
+}
+
+TEST(PerfRecordTest, ThrowsOnUnknownFormat) {
+  EXPECT_THROW(WritePerfRecord(nlohmann::ordered_json::object(), "unused", "xml"), std::runtime_error);
+}
+
+TEST(PerfTest, PrintPerfStatisticWritesRecordWhenOutputDirIsSet) {
+  const auto dir = std::filesystem::temp_directory_path() / "ppc_perf_record_print";
+  std::filesystem::remove_all(dir);
+  env::detail::set_scoped_environment_variable scoped_dir("PPC_PERF_OUTPUT_DIR", dir.string());
+  env::detail::set_scoped_environment_variable scoped_format("PPC_PERF_OUTPUT_FORMAT", "jsonl");
+
+  auto task_ptr = std::make_shared<DummyTask>();
+  task_ptr->SetTypeOfTask(TypeOfTask::kSEQ);
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  attr.num_running = 1;
+  perf.PipelineRun(attr);
+
+  ::testing::internal::CaptureStdout();
+  perf.PrintPerfStatistic("record_test_seq_enabled");
+  const std::string output = ::testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("record_test_seq_enabled:pipeline:"), std::string::npos);
+
+  std::ifstream file(dir / "perf_results.jsonl");
+  std::string line;
+  ASSERT_TRUE(std::getline(file, line));
+  const auto record = nlohmann::json::parse(line);
+  EXPECT_EQ(record["task"], "record_test");
+  EXPECT_EQ(record["backend"], "seq");
+  EXPECT_EQ(record["mode"], "pipeline");
+  EXPECT_EQ(record["input_size"], 1);
+  file.close();
+  std::filesystem::remove_all(dir);
+}
+
+TEST(PerfBaselineTest, MannWhitneyDetectsSlowerSamples) {
+  const std::vector<double> baseline = {1.0, 1.1, 0.9, 1.05, 0.95};
+  EXPECT_LT(MannWhitneyGreaterPValue({3.0, 3.1, 2.9, 3.05, 2.95}, baseline), 0.05);
+  EXPECT_GT(MannWhitneyGreaterPValue(baseline, baseline), 0.4);
+  EXPECT_DOUBLE_EQ(MannWhitneyGreaterPValue({}, baseline), 1.0);
+}
+
+TEST(PerfBaselineTest, FlagsOnlySignificantSlowdownBeyondThreshold) {
+  PerfBaseline baseline{.median_sec = 1.0, .samples = {1.0, 1.1, 0.9, 1.05, 0.95}};
+  PerfResults slow;
+  slow.samples = {3.0, 3.1, 2.9, 3.05, 2.95};
+  slow.time_sec = 3.0;
+  const auto check = CheckRegression(baseline, slow, 0.1);
+  EXPECT_TRUE(check.regressed);
+  EXPECT_DOUBLE_EQ(check.ratio, 3.0);
+
+  PerfResults similar;
+  similar.samples = {1.02, 1.12, 0.92, 1.07, 0.97};
+  similar.time_sec = 1.02;
+  EXPECT_FALSE(CheckRegression(baseline, similar, 0.1).regressed);
+
+  PerfResults noisy;
+  noisy.samples = {0.5, 2.0, 0.8, 1.3, 1.5};
+  noisy.time_sec = 1.3;
+  EXPECT_FALSE(CheckRegression(baseline, noisy, 0.1).regressed);
+}
+
+TEST(PerfBaselineTest, StoreAndLoadRoundTrip) {
+  const auto path = std::filesystem::temp_directory_path() / "ppc_perf_baseline_roundtrip" / "baseline.json";
+  std::filesystem::remove_all(path.parent_path());
+  EXPECT_FALSE(LoadPerfBaseline(path.string(), "a_seq_enabled", "pipeline").has_value());
+
+  PerfResults results;
+  results.time_sec = 0.25;
+  results.samples = {0.2, 0.25, 0.3};
+  StorePerfBaseline(path.string(), "a_seq_enabled", "pipeline", results);
+  results.time_sec = 0.5;
+  StorePerfBaseline(path.string(), "b_seq_enabled", "task_run", results);
+
+  const auto loaded = LoadPerfBaseline(path.string(), "a_seq_enabled", "pipeline");
+  ASSERT_TRUE(loaded.has_value());
+  EXPECT_DOUBLE_EQ(loaded->median_sec, 0.25);
+  EXPECT_EQ(loaded->samples, results.samples);
+  EXPECT_FALSE(LoadPerfBaseline(path.string(), "a_seq_enabled", "task_run").has_value());
+  EXPECT_DOUBLE_EQ(LoadPerfBaseline(path.string(), "b_seq_enabled", "task_run")->median_sec, 0.5);
+  std::filesystem::remove_all(path.parent_path());
+}
+
+TEST(PerfTest, PrintPerfStatisticFailsOnBaselineRegression) {
+  const auto path = std::filesystem::temp_directory_path() / "ppc_perf_baseline_regression.json";
+  {
+    std::ofstream file(path);
+    file << R"({"regress_seq_enabled": {"pipeline": {"median_sec": 0.1, "samples": [0.1, 0.1, 0.1, 0.1, 0.1]}}})";
+  }
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_BASELINE_FILE", path.string());
+
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  double time = 0.0;
+  attr.current_timer = [&time] { return time += 1.0; };
+  perf.PipelineRun(attr);
+
+  ::testing::internal::CaptureStdout();
+  EXPECT_THROW(perf.PrintPerfStatistic("regress_seq_enabled"), std::runtime_error);
+  const std::string output = ::testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("regress_seq_enabled:pipeline:baseline_ratio:"), std::string::npos);
+  std::filesystem::remove(path);
+}
+
+TEST(PerfTest, PrintPerfStatisticUpdatesBaselineWhenRequested) {
+  const auto path = std::filesystem::temp_directory_path() / "ppc_perf_baseline_update.json";
+  std::filesystem::remove(path);
+  env::detail::set_scoped_environment_variable scoped_file("PPC_PERF_BASELINE_FILE", path.string());
+  env::detail::set_scoped_environment_variable scoped_update("PPC_PERF_UPDATE_BASELINE", "1");
+
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  double time = 0.0;
+  attr.current_timer = [&time] { return time += 1.0; };
+  perf.PipelineRun(attr);
+
+  ::testing::internal::CaptureStdout();
+  EXPECT_NO_THROW(perf.PrintPerfStatistic("update_seq_enabled"));
+  ::testing::internal::GetCapturedStdout();
+  const auto stored = LoadPerfBaseline(path.string(), "update_seq_enabled", "pipeline");
+  ASSERT_TRUE(stored.has_value());
+  EXPECT_DOUBLE_EQ(stored->median_sec, 1.0);
+  EXPECT_EQ(stored->samples.size(), attr.num_running);
+  std::filesystem::remove(path);
+}
+
+TEST(PerfTest, ThreadSweepCountsDoubleUpToMaximum) {
+  EXPECT_EQ(ThreadSweepCounts(0), std::vector<int>({1}));
+  EXPECT_EQ(ThreadSweepCounts(1), std::vector<int>({1}));
+  EXPECT_EQ(ThreadSweepCounts(2), std::vector<int>({1, 2}));
+  EXPECT_EQ(ThreadSweepCounts(6), std::vector<int>({1, 2, 4, 6}));
+  EXPECT_EQ(ThreadSweepCounts(8), std::vector<int>({1, 2, 4, 8}));
+}
+
+TEST(PerfTest, SizeLadderHalvesDownFromMaximum) {
+  EXPECT_EQ(SizeLadder(1000, 4), std::vector<std::size_t>({125, 250, 500, 1000}));
+  EXPECT_EQ(SizeLadder(3, 4), std::vector<std::size_t>({1, 3}));
+  EXPECT_TRUE(SizeLadder(0, 4).empty());
+}
+
+TEST(PerfTest, FitComplexityRecoversPowerLaw) {
+  const std::vector<double> sizes = {1000.0, 2000.0, 4000.0, 8000.0};
+  std::vector<double> linear;
+  std::vector<double> quadratic;
+  for (double n : sizes) {
+    linear.push_back(2e-9 * n);
+    quadratic.push_back(1e-12 * n * n);
+  }
+  const auto linear_fit = FitComplexity(sizes, linear);
+  EXPECT_NEAR(linear_fit.exponent, 1.0, 1e-9);
+  EXPECT_NEAR(linear_fit.coefficient, 2e-9, 1e-15);
+  EXPECT_NEAR(linear_fit.r_squared, 1.0, 1e-9);
+  EXPECT_NEAR(FitComplexity(sizes, quadratic).exponent, 2.0, 1e-9);
+  EXPECT_DOUBLE_EQ(FitComplexity({1000.0}, {1.0}).exponent, 0.0);
+}
+
+TEST(PerfTest, ColdCacheModeMeasuresSeparateSamples) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  attr.num_running = 3;
+  attr.cold_cache = true;
+  attr.cache_flush_bytes = std::size_t{1} << 16;
+  double time = 0.0;
+  attr.current_timer = [&time] { return time += 1.0; };
+  perf.PipelineRun(attr);
+
+  const auto results = perf.GetPerfResults();
+  EXPECT_EQ(results.samples.size(), 3U);
+  EXPECT_EQ(results.cold_samples.size(), 3U);
+  EXPECT_DOUBLE_EQ(results.cold_statistics.median, 1.0);
+  EXPECT_EQ(task_ptr->GetTaskStats().run.calls, 6U);
+  EXPECT_EQ(results.stage_stats.run.calls, 3U);
+  EXPECT_EQ(results.stage_stats.pre_processing.calls, 3U);
+
+  ::testing::internal::CaptureStdout();
+  perf.PrintPerfStatistic("cold_test");
+  const std::string output = ::testing::internal::GetCapturedStdout();
+  EXPECT_NE(output.find("cold_test:pipeline:cold:median:"), std::string::npos);
+}
+
+TEST(PerfTest, ColdCacheTaskRunKeepsColdIterationsOutOfStageStats) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  attr.num_running = 4;
+  attr.cold_cache = true;
+  attr.cache_flush_bytes = std::size_t{1} << 16;
+  perf.TaskRun(attr);
+
+  const auto &results = perf.GetPerfResults();
+  EXPECT_EQ(results.samples.size(), 4U);
+  EXPECT_EQ(results.cold_samples.size(), 4U);
+  EXPECT_EQ(results.stage_stats.run.calls, 4U);
+  EXPECT_EQ(results.stage_stats.post_processing.calls, 1U);
+}
+
+TEST(PerfTest, WarmModeHasNoColdSamples) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  attr.num_running = 2;
+  perf.TaskRun(attr);
+  EXPECT_TRUE(perf.GetPerfResults().cold_samples.empty());
+}
+
+class RunStartRecordingTask : public Task<int, int> {
+ public:
+  std::vector<int> run_starts;
+
+ protected:
+  bool ValidationImpl() override {
+    return true;
+  }
+  bool PreProcessingImpl() override {
+    GetOutput() = 0;
+    return true;
+  }
+  bool RunImpl() override {
+    run_starts.push_back(GetOutput());
+    GetOutput() += 1;
+    return true;
+  }
+  bool PostProcessingImpl() override {
+    return true;
+  }
+};
+
+TEST(PerfTest, TaskRunRestoresStateBeforeEveryIteration) {
+  PerfAttr attr;
+  attr.num_warmup = 1;
+  attr.num_running = 3;
+
+  auto restored = std::make_shared<RunStartRecordingTask>();
+  Perf<int, int>(restored).TaskRun(attr);
+  // Warmup, three measured iterations and the final checked pipeline
+  EXPECT_EQ(restored->run_starts, std::vector<int>({0, 0, 0, 0, 0}));
+
+  attr.restore_run_state = false;
+  auto accumulated = std::make_shared<RunStartRecordingTask>();
+  Perf<int, int>(accumulated).TaskRun(attr);
+  EXPECT_EQ(accumulated->run_starts, std::vector<int>({0, 1, 2, 3, 0}));
+}
+
+TEST(PerfTest, HardwareCountersDegradeGracefully) {
+  ppc::performance::HardwareCounters counters;
+  counters.Start();
+  volatile double sum = 0.0;
+  for (int i = 0; i < 100000; i++) {
+    sum = sum + (i * 0.5);
+  }
+  counters.Stop();
+
+  const auto values = counters.Read();
+  const bool any_value = std::ranges::any_of(values, [](const auto &value) { return value.has_value(); });
+  EXPECT_EQ(any_value, counters.Available());
+  const auto &instructions = values[static_cast<std::size_t>(ppc::performance::HardwareCounter::kInstructions)];
+  if (instructions.has_value()) {
+    EXPECT_GT(*instructions, 0.0);
+  }
+}
+
+TEST(PerfTest, HardwareCountersCountThreadsStartedBeforehand) {
+  std::atomic<bool> go{false};
+  constexpr int kIterations = 10000000;
+  std::thread worker([&go] {
+    while (!go.load()) {
+      std::this_thread::yield();
+    }
+    volatile int sum = 0;
+    for (int i = 0; i < kIterations; i++) {
+      sum = sum + i;
+    }
+  });
+
+  ppc::performance::HardwareCounters counters;
+  counters.Start();
+  go = true;
+  worker.join();
+  counters.Stop();
+
+  const auto values = counters.Read();
+  const auto &instructions = values[static_cast<std::size_t>(ppc::performance::HardwareCounter::kInstructions)];
+  if (!instructions.has_value()) {
+    GTEST_SKIP() << "Hardware counters are unavailable";
+  }
+  EXPECT_GE(*instructions, static_cast<double>(kIterations));
+}
+
+TEST(PerfTest, InstructionsPerCycleNeedsBothCounters) {
+  ppc::performance::HardwareCounterValues counters{};
+  EXPECT_FALSE(ppc::performance::InstructionsPerCycle(counters).has_value());
+  counters[static_cast<std::size_t>(ppc::performance::HardwareCounter::kCycles)] = 200.0;
+  counters[static_cast<std::size_t>(ppc::performance::HardwareCounter::kInstructions)] = 300.0;
+  EXPECT_DOUBLE_EQ(ppc::performance::InstructionsPerCycle(counters).value(), 1.5);
+}
+
+TEST(PerfTest, HardwareCounterModeRecordsCountersOfEveryRank) {
+  auto task_ptr = std::make_shared<DummyTask>();
+  Perf<int, int> perf(task_ptr);
+  PerfAttr attr;
+  attr.num_running = 3;
+  attr.hardware_counters = true;
+  attr.all_gather = [](const std::vector<double> &local) {
+    std::vector<double> gathered = local;
+    gathered.insert(gathered.end(), local.begin(), local.end());
+    return gathered;
+  };
+  perf.PipelineRun(attr);
+
+  const auto results = perf.GetPerfResults();
+  EXPECT_EQ(ppc::performance::HardwareCounters().Available(),
+            std::ranges::any_of(results.counters, [](const auto &value) { return value.has_value(); }));
+
+  const auto record = ppc::performance::MakePerfRecord(results, "counters_test_seq_enabled", "seq", "pipeline");
+  EXPECT_TRUE(record.contains("instructions"));
+  EXPECT_TRUE(record.contains("ipc"));
+  EXPECT_NO_THROW(perf.PrintPerfStatistic("counters_test"));
+}
+
+TEST(PerfTest, MpiProfileIsSummarizedPerStageAndDestination) {
+  auto entry = [](std::string stage, std::string function, int peer, bool sends, uint64_t bytes) {
+    ppc::util::MpiProfileEntry result;
+    result.stage = std::move(stage);
+    result.function = std::move(function);
+    result.peer = peer;
+    result.sends = sends;
+    result.calls = 2;
+    result.bytes = bytes;
+    result.time_sec = 0.5;
+    return result;
+  };
+  const std::vector<ppc::util::MpiProfileEntry> profile = {
+      entry("run", "MPI_Send", 1, true, 100),  entry("run", "MPI_Send", 2, true, 50),
+      entry("run", "MPI_Recv", 1, false, 70),  entry("run", "MPI_Bcast", 0, false, 8),
+      entry("pre_processing", "MPI_Send", 1, true, 1000), entry("run", "MPI_Send", 5, true, 10),
+  };
+
+  const auto summary = SummarizeMpiProfile(profile, "run");
+  ASSERT_EQ(summary.size(), 3U);
+  EXPECT_EQ(summary.at("MPI_Send").calls, 6U);
+  EXPECT_EQ(summary.at("MPI_Send").bytes, 160U);
+  EXPECT_DOUBLE_EQ(summary.at("MPI_Send").time_sec, 1.5);
+  EXPECT_EQ(summary.at("MPI_Recv").bytes, 70U);
+  EXPECT_TRUE(SummarizeMpiProfile(profile, "validation").empty());
+
+  // Receives, collectives, other stages and peers outside the world are not part of the matrix
+  EXPECT_EQ(CommunicationRow(profile, "run", 3), (std::vector<double>{0.0, 100.0, 50.0}));
+  EXPECT_EQ(CommunicationRow(profile, "pre_processing", 2), (std::vector<double>{0.0, 1000.0}));
+}
+
+TEST(CommBenchTest, IterationsMoveAFixedVolumeWithinBounds) {
+  EXPECT_EQ(CommBenchIterations(0), 1000U);
+  EXPECT_EQ(CommBenchIterations(1), 1000U);
+  EXPECT_EQ(CommBenchIterations(std::size_t{1} << 20), 256U);
+  EXPECT_EQ(CommBenchIterations(std::size_t{256} << 20), 2U);
+}
+
+TEST(CommBenchTest, SizesArePowersOfTwoFromOneByte) {
+  EXPECT_EQ(CommBenchSizes(8), std::vector<std::size_t>({1, 2, 4, 8}));
+  EXPECT_EQ(CommBenchSizes(1000), std::vector<std::size_t>({1, 2, 4, 8, 16, 32, 64, 128, 256, 512}));
+  EXPECT_EQ(CommBenchSizes(1), std::vector<std::size_t>({1}));
+  EXPECT_TRUE(CommBenchSizes(0).empty());
+}
+
+TEST(CommBenchTest, PointToPointPatternsNeedTwoProcesses) {
+  EXPECT_FALSE(IsCommBenchmarkApplicable(CommBenchmark::kPingPong, 1));
+  EXPECT_FALSE(IsCommBenchmarkApplicable(CommBenchmark::kHypercube, 1));
+  EXPECT_TRUE(IsCommBenchmarkApplicable(CommBenchmark::kSendrecv, 2));
+  EXPECT_TRUE(IsCommBenchmarkApplicable(CommBenchmark::kBcast, 1));
+}
+
+TEST(CommBenchTest, RecordContainsBenchmarkAndBandwidth) {
+  CommBenchResult result;
+  result.benchmark = CommBenchmark::kAllgatherv;
+  result.bytes = 4096;
+  result.processes = 4;
+  result.iterations = 1000;
+  result.time_sec = 2e-6;
+  result.bandwidth_bytes_per_sec = 2.048e9;
+  const auto record = MakeCommBenchRecord(result);
+  EXPECT_EQ(record.at("benchmark"), "allgatherv");
+  EXPECT_EQ(record.at("bytes"), 4096);
+  EXPECT_EQ(record.at("processes"), 4);
+  EXPECT_DOUBLE_EQ(record.at("bandwidth_gbs").get<double>(), 2.048);
+  EXPECT_TRUE(record.contains("hostname"));
+}
+
+TEST(RooflineTest, ProbesReportPositivePeaks) {
+  EXPECT_GT(MeasureStreamBandwidth(std::size_t{1} << 20, 1), 0.0);
+  EXPECT_GT(MeasurePeakFlops(1), 0.0);
+}
+
+TEST(RooflineTest, StreamArraysOfANodeAreSplitBetweenItsRanks) {
+  constexpr std::size_t kMb = std::size_t{1} << 20;
+  EXPECT_EQ(StreamArrayBytes(32 * kMb, 1), 128 * kMb);
+  EXPECT_EQ(StreamArrayBytes(32 * kMb, 4), 32 * kMb);
+  EXPECT_EQ(StreamArrayBytes(1 * kMb, 1), 32 * kMb);
+  EXPECT_EQ(StreamArrayBytes(512 * kMb, 16), 16 * kMb);
+  EXPECT_EQ(StreamArrayBytes(32 * kMb, 0), 128 * kMb);
+}
+
+TEST(RooflineTest, PercentIsTakenAgainstTheBindingRoof) {
+  MachinePeaks peaks;
+  peaks.bandwidth_bytes_per_sec = 10e9;
+  peaks.flops_per_sec = 100e9;
+
+  // Memory-bound kernel: 1 flop per byte caps the attainable rate at 10 GFLOP/s
+  const auto memory_bound = ComputeRoofline(1'000'000'000, 1'000'000'000, 0.2, peaks);
+  EXPECT_DOUBLE_EQ(memory_bound.bandwidth_bytes_per_sec, 5e9);
+  EXPECT_DOUBLE_EQ(memory_bound.arithmetic_intensity, 1.0);
+  EXPECT_DOUBLE_EQ(memory_bound.percent_of_roofline, 50.0);
+
+  // Compute-bound kernel: 100 flops per byte reaches the flop peak
+  const auto compute_bound = ComputeRoofline(10'000'000, 1'000'000'000, 0.05, peaks);
+  EXPECT_DOUBLE_EQ(compute_bound.percent_of_roofline, 20.0);
+
+  // Without flops the kernel is compared with the bandwidth alone
+  EXPECT_DOUBLE_EQ(ComputeRoofline(2'000'000'000, 0, 1.0, peaks).percent_of_roofline, 20.0);
+  EXPECT_DOUBLE_EQ(ComputeRoofline(2'000'000'000, 0, 0.0, peaks).percent_of_roofline, 0.0);
+}
+
+TEST(PerfTest, DeclaredBytesProduceRooflineReport) {
+  PerfAttr attr;
+  double time = 0.0;
+  attr.current_timer = [&time] {
+    time += 0.5;
+    return time;
+  };
+  Perf<std::vector<int>, int> undeclared(
+      std::make_shared<ppc::test::TestPerfTask<std::vector<int>, int>>(std::vector<int>(100, 1)));
+  undeclared.TaskRun(attr);
+  EXPECT_FALSE(undeclared.GetPerfResults().roofline.has_value());
+
+  attr.bytes_moved = 400;
+  Perf<std::vector<int>, int> perf(
+      std::make_shared<ppc::test::TestPerfTask<std::vector<int>, int>>(std::vector<int>(100, 1)));
+  perf.TaskRun(attr);
+  const auto roofline = perf.GetPerfResults().roofline;
+  ASSERT_TRUE(roofline.has_value());
+  EXPECT_DOUBLE_EQ(roofline->bandwidth_bytes_per_sec, 800.0);
+  EXPECT_GT(roofline->peaks.bandwidth_bytes_per_sec, 0.0);
+}
+
 TEST(PerfTest, PrintPerfStatisticThrowsOnNone) {
   {
     auto task_ptr = std::make_shared<DummyTask>();
@@ -8,7 +8,8 @@
 namespace ppc::runners {
 
 /// @brief GTest event listener that checks for unread MPI messages after each test.
-/// @note Used to detect unexpected inter-process communication leftovers.
+/// @note Used to detect unexpected inter-process communication leftovers on the task parent communicator, i.e. of
+///       tasks that still use MPI_COMM_WORLD instead of Task::GetComm().
 class UnreadMessagesDetector : public ::testing::EmptyTestEventListener {
  public:
   UnreadMessagesDetector() = default;
@@ -39,9 +40,11 @@ class WorkerTestFailurePrinter : public ::testing::EmptyTestEventListener {
 /// @brief Initializes the testing environment (e.g., MPI, logging).
 /// @param argc Argument count.
 /// @param argv Argument vector.
+/// @param runner_groups Whether PPC_RUNNER_GROUPS may split the ranks into groups; performance runners pass false,
+///        since groups running side by side would disturb each other's timings.
 /// @return Exit code from RUN_ALL_TESTS or MPI error code if initialization/
 ///         finalization fails.
-int Init(int argc, char **argv);
+int Init(int argc, char **argv, bool runner_groups = true);
 
 /// @brief Initializes the testing environment only for gtest.
 /// @param argc Argument count.
@@ -49,4 +52,15 @@ int Init(int argc, char **argv);
 /// @return Exit code from RUN_ALL_TESTS.
 int SimpleInit(int argc, char **argv);
 
+/// @brief Number of runner groups used for size ranks when requested groups are asked for, clamped to [1, size].
+int CountRunnerGroups(int requested, int size);
+
+/// @brief Runner group of a rank; the groups hold consecutive ranks and differ in size by at most one rank.
+int RunnerGroupOfRank(int rank, int size, int groups);
+
+/// @brief GoogleTest sharding that splits the outer shard shard_index of total_shards between the runner groups.
+/// @return GTEST_TOTAL_SHARDS and GTEST_SHARD_INDEX of the group; the tests of all groups together are exactly the
+///         tests of the outer shard.
+std::pair<int, int> GroupTestShard(int total_shards, int shard_index, int group, int groups);
+
 }  // namespace ppc::runners
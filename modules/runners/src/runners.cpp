@@ -3,33 +3,45 @@
 #include <gtest/gtest.h>
 #include <mpi.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <exception>
 #include <format>
 #include <iostream>
+#include <libenvpp/detail/environment.hpp>
+#include <libenvpp/detail/get.hpp>
 #include <memory>
 #include <random>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
-#include "oneapi/tbb/global_control.h"
+#include "util/include/mpi_threads.hpp"
+#include "util/include/node_shared.hpp"
+#include "util/include/task_comm.hpp"
+#include "util/include/thread_runtime.hpp"
+#include "util/include/trace.hpp"
 #include "util/include/util.hpp"
 
 namespace ppc::runners {
 
 void UnreadMessagesDetector::OnTestEnd(const ::testing::TestInfo & /*test_info*/) {
+  // Tasks talk on private duplicates, so only messages that bypass GetComm() can be left on the parent
+  const MPI_Comm comm = ppc::util::GetTaskParentComm();
   int rank = -1;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(comm, &rank);
 
-  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Barrier(comm);
 
   int flag = -1;
   MPI_Status status;
 
-  const int iprobe_res = MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status);
+  const int iprobe_res = MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm, &flag, &status);
   if (iprobe_res != MPI_SUCCESS) {
     std::cerr << std::format("[  PROCESS {}  ] [  ERROR  ] MPI_Iprobe failed with code {}", rank, iprobe_res) << '\n';
     MPI_Abort(MPI_COMM_WORLD, iprobe_res);
@@ -44,7 +56,7 @@ void UnreadMessagesDetector::OnTestEnd(const ::testing::TestInfo & /*test_info*/
     MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
   }
 
-  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Barrier(comm);
 }
 
 void WorkerTestFailurePrinter::OnTestEnd(const ::testing::TestInfo &test_info) {
@@ -124,6 +136,156 @@ bool HasFlag(int argc, char **argv, std::string_view flag) {
   return false;
 }
 
+// Tag the events of this rank and start the timelines of all ranks together
+void StartTrace() {
+  if (ppc::util::GetTraceFile().empty()) {
+    return;
+  }
+  int rank = -1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  ppc::util::SetTraceProcess(rank);
+  MPI_Barrier(MPI_COMM_WORLD);
+  ppc::util::ResetTraceClock();
+}
+
+// Collect the events of every rank on rank 0, which writes the trace file
+void FinishTrace() {
+  if (ppc::util::GetTraceFile().empty()) {
+    return;
+  }
+  int rank = -1;
+  int size = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  const std::string local = ppc::util::TakeTraceEvents();
+  int local_len = static_cast<int>(local.size());
+  std::vector<int> lengths(static_cast<std::size_t>(size));
+  MPI_Gather(&local_len, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> displs(static_cast<std::size_t>(size));
+  for (std::size_t i = 1; i < displs.size(); i++) {
+    displs[i] = displs[i - 1] + lengths[i - 1];
+  }
+  std::string gathered((rank == 0) ? static_cast<std::size_t>(displs.back() + lengths.back()) : 0, '\0');
+  MPI_Gatherv(local.data(), local_len, MPI_CHAR, gathered.data(), lengths.data(), displs.data(), MPI_CHAR, 0,
+              MPI_COMM_WORLD);
+  if (rank != 0) {
+    return;
+  }
+  std::vector<std::string> chunks;
+  for (std::size_t i = 0; i < lengths.size(); i++) {
+    chunks.push_back(gathered.substr(static_cast<std::size_t>(displs[i]), static_cast<std::size_t>(lengths[i])));
+  }
+  ppc::util::WriteTraceFile(ppc::util::GetTraceFile(), chunks);
+}
+
+/// Consecutive ranks that run their share of the tests side by side with the other groups
+struct RunnerGroup {
+  MPI_Comm comm = MPI_COMM_WORLD;
+  int index = 0;
+  int count = 1;
+};
+
+RunnerGroup SplitRunnerGroups(bool allowed) {
+  int rank = -1;
+  int size = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  RunnerGroup group;
+  const int requested = ppc::util::GetRunnerGroups();
+  if (!allowed) {
+    if (requested > 1 && rank == 0) {
+      std::cerr << std::format("[  WARNING ] PPC_RUNNER_GROUPS={} is ignored, performance tests run on all ranks",
+                               requested)
+                << '\n';
+    }
+    return group;
+  }
+  group.count = CountRunnerGroups(requested, size);
+  if (group.count == 1) {
+    return group;
+  }
+  group.index = RunnerGroupOfRank(rank, size, group.count);
+  MPI_Comm_split(MPI_COMM_WORLD, group.index, rank, &group.comm);
+  return group;
+}
+
+void ShardTestsByGroup(const RunnerGroup &group) {
+  if (group.count == 1) {
+    return;
+  }
+  const auto total_env = env::get<int>("GTEST_TOTAL_SHARDS");
+  const auto index_env = env::get<int>("GTEST_SHARD_INDEX");
+  const int total_shards = total_env.has_value() ? total_env.value() : 1;
+  const int shard_index = index_env.has_value() ? index_env.value() : 0;
+  const auto [group_total, group_index] = GroupTestShard(total_shards, shard_index, group.index, group.count);
+  env::detail::set_environment_variable("GTEST_TOTAL_SHARDS", std::to_string(group_total));
+  env::detail::set_environment_variable("GTEST_SHARD_INDEX", std::to_string(group_index));
+}
+
+std::string DescribeGroupResults(const RunnerGroup &group, int group_size) {
+  const auto &unit_test = *::testing::UnitTest::GetInstance();
+  std::string failed_names;
+  for (int suite = 0; suite < unit_test.total_test_suite_count(); suite++) {
+    const auto &test_suite = *unit_test.GetTestSuite(suite);
+    for (int test = 0; test < test_suite.total_test_count(); test++) {
+      const auto &test_info = *test_suite.GetTestInfo(test);
+      if (test_info.should_run() && test_info.result()->Failed()) {
+        failed_names += std::format(" {}.{}", test_suite.name(), test_info.name());
+      }
+    }
+  }
+  return std::format("[  GROUP {}  ] {} ranks: {} passed, {} skipped, {} failed{}", group.index, group_size,
+                     unit_test.successful_test_count(), unit_test.skipped_test_count(), unit_test.failed_test_count(),
+                     failed_names);
+}
+
+// Rank 0 prints the results of every group; the returned status is the worst one of all ranks
+int ReportGroupResults(const RunnerGroup &group, int status) {
+  int worst_status = status;
+  MPI_Allreduce(&status, &worst_status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (group.count == 1) {
+    return worst_status;
+  }
+  int group_rank = -1;
+  int group_size = 0;
+  MPI_Comm_rank(group.comm, &group_rank);
+  MPI_Comm_size(group.comm, &group_size);
+  const std::string local = (group_rank == 0) ? DescribeGroupResults(group, group_size) : std::string{};
+  int rank = -1;
+  int size = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  int local_len = static_cast<int>(local.size());
+  std::vector<int> lengths(static_cast<std::size_t>(size));
+  MPI_Gather(&local_len, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  std::vector<int> displs(static_cast<std::size_t>(size));
+  for (std::size_t i = 1; i < displs.size(); i++) {
+    displs[i] = displs[i - 1] + lengths[i - 1];
+  }
+  std::string gathered((rank == 0) ? static_cast<std::size_t>(displs.back() + lengths.back()) : 0, '\0');
+  MPI_Gatherv(local.data(), local_len, MPI_CHAR, gathered.data(), lengths.data(), displs.data(), MPI_CHAR, 0,
+              MPI_COMM_WORLD);
+  if (rank == 0) {
+    for (std::size_t i = 0; i < lengths.size(); i++) {
+      if (lengths[i] > 0) {
+        std::cout << gathered.substr(static_cast<std::size_t>(displs[i]), static_cast<std::size_t>(lengths[i])) << '\n';
+      }
+    }
+  }
+  return worst_status;
+}
+
+// Tasks that need more than the provided level can check ppc::util::GetMpiThreadLevel() and skip themselves
+void WarnAboutMpiThreadLevel(ppc::util::MpiThreadLevel requested, ppc::util::MpiThreadLevel provided) {
+  int rank = -1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (provided < requested && rank == 0) {
+    std::cerr << std::format("[  WARNING ] MPI provides thread level {} instead of the requested {}",
+                             ppc::util::MpiThreadLevelName(provided), ppc::util::MpiThreadLevelName(requested))
+              << '\n';
+  }
+}
+
 int RunAllTestsSafely() {
   try {
     return RunAllTests();
@@ -139,16 +301,31 @@ int RunAllTestsSafely() {
 }
 }  // namespace
 
-int Init(int argc, char **argv) {
-  const int init_res = MPI_Init(&argc, &argv);
+int Init(int argc, char **argv, bool runner_groups) {
+  ppc::util::MpiThreadLevel requested_level{};
+  try {
+    requested_level = ppc::util::GetRequestedMpiThreadLevel();
+  } catch (const std::invalid_argument &e) {
+    std::cerr << std::format("[  ERROR  ] PPC_MPI_THREAD_LEVEL: {}; expected single, funneled, serialized or multiple",
+                             e.what())
+              << '\n';
+    return EXIT_FAILURE;
+  }
+  int provided = MPI_THREAD_SINGLE;
+  const int init_res = MPI_Init_thread(&argc, &argv, ppc::util::ToMpiThreadConstant(requested_level), &provided);
   if (init_res != MPI_SUCCESS) {
-    std::cerr << std::format("[  ERROR  ] MPI_Init failed with code {}", init_res) << '\n';
+    std::cerr << std::format("[  ERROR  ] MPI_Init_thread failed with code {}", init_res) << '\n';
     MPI_Abort(MPI_COMM_WORLD, init_res);
     return init_res;
   }
+  WarnAboutMpiThreadLevel(requested_level, ppc::util::FromMpiThreadConstant(provided));
+  // Node-wide probes such as the roofline STREAM arrays are split between the ranks of a node
+  ppc::util::mpi::CountWorldRanksOnNode();
 
   // Limit the number of threads in TBB
-  tbb::global_control control(tbb::global_control::max_allowed_parallelism, ppc::util::GetNumThreads());
+  const ppc::util::ScopedNumThreads thread_limit(0);
+  // Keep the worker threads alive across tasks instead of recreating them for every test
+  ppc::util::WarmUpThreadRuntime();
 
   ::testing::InitGoogleTest(&argc, argv);
 
@@ -166,7 +343,21 @@ int Init(int argc, char **argv) {
   }
   listeners.Append(new UnreadMessagesDetector());
 
-  const int status = RunAllTestsSafely();
+  RunnerGroup group = SplitRunnerGroups(runner_groups);
+  ShardTestsByGroup(group);
+  int status = EXIT_SUCCESS;
+  {
+    // Tasks and the test utilities of every group work on the group communicator
+    const ppc::util::ScopedTaskParentComm group_comm(group.comm);
+    StartTrace();
+    status = RunAllTestsSafely();
+    FinishTrace();
+  }
+  status = ReportGroupResults(group, status);
+  if (group.comm != MPI_COMM_WORLD) {
+    MPI_Comm_free(&group.comm);
+  }
+  ppc::util::ReleaseThreadRuntime();
 
   const int finalize_res = MPI_Finalize();
   if (finalize_res != MPI_SUCCESS) {
@@ -177,12 +368,35 @@ int Init(int argc, char **argv) {
   return status;
 }
 
+int CountRunnerGroups(int requested, int size) {
+  return std::clamp(requested, 1, std::max(size, 1));
+}
+
+int RunnerGroupOfRank(int rank, int size, int groups) {
+  return static_cast<int>((static_cast<std::int64_t>(rank) * groups) / size);
+}
+
+// GoogleTest runs the test at position p of the filtered list in the shard p % total. The group shard selects the
+// tests with p % total_shards == shard_index and (p / total_shards) % groups == group, so the groups split the
+// outer shard between them
+std::pair<int, int> GroupTestShard(int total_shards, int shard_index, int group, int groups) {
+  return {total_shards * groups, shard_index + (group * total_shards)};
+}
+
 int SimpleInit(int argc, char **argv) {
   // Limit the number of threads in TBB
-  tbb::global_control control(tbb::global_control::max_allowed_parallelism, ppc::util::GetNumThreads());
+  const ppc::util::ScopedNumThreads thread_limit(0);
+  // Keep the worker threads alive across tasks instead of recreating them for every test
+  ppc::util::WarmUpThreadRuntime();
 
   testing::InitGoogleTest(&argc, argv);
-  return RunAllTests();
+  const int status = RunAllTests();
+  ppc::util::ReleaseThreadRuntime();
+  const auto trace_file = ppc::util::GetTraceFile();
+  if (!trace_file.empty()) {
+    ppc::util::WriteTraceFile(trace_file, {ppc::util::TakeTraceEvents()});
+  }
+  return status;
 }
 
 }  // namespace ppc::runners
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "runners/include/runners.hpp"
+
+using ppc::runners::CountRunnerGroups;
+using ppc::runners::GroupTestShard;
+using ppc::runners::RunnerGroupOfRank;
+
+TEST(RunnerGroupsTest, ClampsTheGroupCountToTheRanks) {
+  EXPECT_EQ(CountRunnerGroups(2, 4), 2);
+  EXPECT_EQ(CountRunnerGroups(8, 3), 3);
+  EXPECT_EQ(CountRunnerGroups(5, 1), 1);
+  EXPECT_EQ(CountRunnerGroups(0, 4), 1);
+  EXPECT_EQ(CountRunnerGroups(-2, 4), 1);
+}
+
+TEST(RunnerGroupsTest, SplitsUnevenRankCountsIntoConsecutiveBalancedGroups) {
+  EXPECT_EQ(RunnerGroupOfRank(0, 7, 3), 0);
+  EXPECT_EQ(RunnerGroupOfRank(2, 7, 3), 0);
+  EXPECT_EQ(RunnerGroupOfRank(3, 7, 3), 1);
+  EXPECT_EQ(RunnerGroupOfRank(6, 7, 3), 2);
+
+  for (int size = 1; size <= 9; size++) {
+    for (int requested = 1; requested <= size + 2; requested++) {
+      const int groups = CountRunnerGroups(requested, size);
+      std::vector<int> group_sizes(static_cast<std::size_t>(groups));
+      int previous = 0;
+      for (int rank = 0; rank < size; rank++) {
+        const int group = RunnerGroupOfRank(rank, size, groups);
+        ASSERT_GE(group, previous) << "size " << size << ", groups " << groups;
+        ASSERT_LT(group, groups);
+        group_sizes[static_cast<std::size_t>(group)]++;
+        previous = group;
+      }
+      const auto [smallest, largest] = std::ranges::minmax(group_sizes);
+      EXPECT_GE(smallest, 1) << "size " << size << ", groups " << groups;
+      EXPECT_LE(largest - smallest, 1) << "size " << size << ", groups " << groups;
+    }
+  }
+}
+
+TEST(RunnerGroupsTest, SplitsEveryOuterShardBetweenTheGroups) {
+  constexpr int kTests = 40;
+  for (const auto &[total_shards, groups] : {std::pair{1, 2}, std::pair{3, 2}, std::pair{2, 3}, std::pair{4, 4}}) {
+    std::vector<int> runs(kTests);
+    for (int shard_index = 0; shard_index < total_shards; shard_index++) {
+      for (int group = 0; group < groups; group++) {
+        const auto [group_total, group_index] = GroupTestShard(total_shards, shard_index, group, groups);
+        ASSERT_LT(group_index, group_total);
+        for (int test = 0; test < kTests; test++) {
+          // GoogleTest selects the tests round-robin over the shards
+          if (test % group_total == group_index) {
+            EXPECT_EQ(test % total_shards, shard_index) << "test " << test << " left its outer shard";
+            runs[static_cast<std::size_t>(test)]++;
+          }
+        }
+      }
+    }
+    EXPECT_TRUE(std::ranges::all_of(runs, [](int count) { return count == 1; }))
+        << total_shards << " shards, " << groups << " groups";
+  }
+}
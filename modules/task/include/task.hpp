@@ -1,18 +1,24 @@
 #pragma once
 
-#include <omp.h>
-
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <util/include/alloc_tracker.hpp>
+#include <util/include/mpi_profiler.hpp>
+#include <util/include/settings.hpp>
+#include <util/include/task_comm.hpp>
+#include <util/include/thread_runtime.hpp>
+#include <util/include/trace.hpp>
 #include <util/include/util.hpp>
 #include <utility>
 
@@ -78,22 +84,27 @@ inline std::string GetStringTaskStatus(StatusOfTask status_of_task) {
 /// @param type_of_task Type of the task.
 /// @param settings_file_path Path to the JSON file containing task type strings.
 /// @return Formatted string combining the task type and its corresponding value from the file.
-/// @throws std::runtime_error If the file cannot be opened.
+/// @throws std::runtime_error If the file cannot be opened or has no status for the task type.
+/// @note The file is parsed once per path and served from ppc::util::GetTaskSettings() afterwards.
 inline std::string GetStringTaskType(TypeOfTask type_of_task, const std::string &settings_file_path) {
-  std::ifstream file(settings_file_path);
-  if (!file.is_open()) {
-    throw std::runtime_error("Failed to open " + settings_file_path);
-  }
-
-  auto list_settings = ppc::util::InitJSONPtr();
-  file >> *list_settings;
+  const auto &settings = ppc::util::GetTaskSettings(settings_file_path);
 
   std::string type_str = TypeOfTaskToString(type_of_task);
   if (type_str == "unknown") {
     return type_str;
   }
 
-  return type_str + "_" + std::string((*list_settings)["tasks"][type_str]);
+  return type_str + "_" + settings.GetStatus(type_str);
+}
+
+/// @brief Returns the status of a task type from the JSON settings file.
+/// @param type_of_task Type of the task.
+/// @param settings_file_path Path to the JSON settings file.
+/// @return kEnabled if the file marks the task type as "enabled", otherwise kDisabled.
+/// @throws std::runtime_error If the file cannot be opened or has no status for the task type.
+inline StatusOfTask GetTaskStatus(TypeOfTask type_of_task, const std::string &settings_file_path) {
+  const auto &settings = ppc::util::GetTaskSettings(settings_file_path);
+  return settings.IsEnabled(TypeOfTaskToString(type_of_task)) ? StatusOfTask::kEnabled : StatusOfTask::kDisabled;
 }
 
 enum class StateOfTesting : uint8_t {
@@ -101,6 +112,64 @@ enum class StateOfTesting : uint8_t {
   kPerf,
 };
 
+/// @brief Timing statistics collected for a single pipeline stage.
+struct StageStats {
+  /// @brief Number of completed calls of the stage.
+  uint64_t calls = 0;
+  /// @brief Duration of the most recent call in seconds.
+  double last_sec = 0.0;
+  /// @brief Accumulated duration of all calls in seconds.
+  double total_sec = 0.0;
+  /// @brief Shortest call duration in seconds.
+  double min_sec = 0.0;
+  /// @brief Longest call duration in seconds.
+  double max_sec = 0.0;
+  /// @brief Heap allocations made by all calls; collected only when allocation tracking is enabled.
+  uint64_t allocations = 0;
+  /// @brief Bytes allocated by all calls.
+  uint64_t allocated_bytes = 0;
+  /// @brief Largest growth of the live heap above its level at the start of a call.
+  uint64_t peak_heap_bytes = 0;
+  /// @brief Peak resident set size of the process after the most recent call.
+  uint64_t peak_rss_bytes = 0;
+
+  /// @brief Adds a measured call duration to the statistics.
+  /// @param sec Call duration in seconds.
+  void Record(double sec) {
+    min_sec = (calls == 0) ? sec : std::min(min_sec, sec);
+    max_sec = (calls == 0) ? sec : std::max(max_sec, sec);
+    last_sec = sec;
+    total_sec += sec;
+    calls++;
+  }
+
+  /// @brief Adds the allocations made during one call.
+  /// @param before Allocation counters at the start of the call, taken after ResetAllocationPeak().
+  /// @param after Allocation counters at the end of the call.
+  void RecordAllocations(const ppc::util::AllocationCounters &before, const ppc::util::AllocationCounters &after) {
+    allocations += after.allocations - before.allocations;
+    allocated_bytes += after.allocated_bytes - before.allocated_bytes;
+    const uint64_t call_peak =
+        (after.peak_live_bytes > before.live_bytes) ? after.peak_live_bytes - before.live_bytes : 0;
+    peak_heap_bytes = std::max(peak_heap_bytes, call_peak);
+    peak_rss_bytes = ppc::util::GetPeakRssBytes();
+  }
+
+  /// @brief Returns the mean call duration.
+  /// @return Mean duration in seconds, or 0 if the stage was never called.
+  [[nodiscard]] double MeanSec() const {
+    return (calls == 0) ? 0.0 : total_sec / static_cast<double>(calls);
+  }
+};
+
+/// @brief Per-stage timing statistics of a task pipeline.
+struct TaskStats {
+  StageStats validation;
+  StageStats pre_processing;
+  StageStats run;
+  StageStats post_processing;
+};
+
 template <typename InType, typename OutType>
 /// @brief Base abstract class representing a generic task with a defined pipeline.
 /// @tparam InType Input data type.
@@ -116,7 +185,11 @@ class Task {
       stage_ = PipelineStage::kException;
       throw std::runtime_error("Validation should be called before preprocessing");
     }
-    return ValidationImpl();
+    // Every rank validates, so the collective duplication cannot be reached by a subset of ranks later on
+    if ((type_of_task_ == TypeOfTask::kMPI || type_of_task_ == TypeOfTask::kALL) && ppc::util::IsMpiActive()) {
+      comm_.Get();
+    }
+    return TimedStage("validation", task_stats_.validation, [this] { return ValidationImpl(); });
   }
 
   /// @brief Performs preprocessing on the input data.
@@ -131,7 +204,7 @@ class Task {
     if (state_of_testing_ == StateOfTesting::kFunc) {
       InternalTimeTest();
     }
-    return PreProcessingImpl();
+    return TimedStage("pre_processing", task_stats_.pre_processing, [this] { return PreProcessingImpl(); });
   }
 
   /// @brief Executes the main logic of the task.
@@ -143,7 +216,7 @@ class Task {
       stage_ = PipelineStage::kException;
       throw std::runtime_error("Run should be called after preprocessing");
     }
-    return RunImpl();
+    return TimedStage("run", task_stats_.run, [this] { return RunImpl(); });
   }
 
   /// @brief Performs postprocessing on the output data.
@@ -158,7 +231,37 @@ class Task {
     if (state_of_testing_ == StateOfTesting::kFunc) {
       InternalTimeTest();
     }
-    return PostProcessingImpl();
+    return TimedStage("post_processing", task_stats_.post_processing, [this] { return PostProcessingImpl(); });
+  }
+
+  /// @brief Returns timing statistics of every pipeline stage called so far.
+  /// @return Reference to the accumulated TaskStats.
+  [[nodiscard]] const TaskStats &GetTaskStats() const {
+    return task_stats_;
+  }
+
+  /// @brief Clears the accumulated per-stage timing statistics.
+  void ResetTaskStats() {
+    task_stats_ = TaskStats{};
+  }
+
+  /// @brief Saves the state that Run() mutates so that a repeated call can start from it again.
+  /// @details Copies the output (when it is copyable) and calls SnapshotRunStateImpl() for task-specific state.
+  void SnapshotRunState() {
+    if constexpr (std::is_copy_assignable_v<OutType>) {
+      output_snapshot_ = output_;
+    }
+    SnapshotRunStateImpl();
+  }
+
+  /// @brief Restores the state saved by the last SnapshotRunState() call.
+  void RestoreRunState() {
+    if constexpr (std::is_copy_assignable_v<OutType>) {
+      if (output_snapshot_.has_value()) {
+        output_ = *output_snapshot_;
+      }
+    }
+    RestoreRunStateImpl();
   }
 
   /// @brief Returns the current testing mode.
@@ -194,9 +297,44 @@ class Task {
   /// @brief Returns a reference to the input data.
   /// @return Reference to the task's input data.
   InType &GetInput() {
+    return *input_;
+  }
+
+  /// @brief Binds input data by moving it into task-owned storage.
+  /// @param in Input data to take ownership of.
+  void BindInput(InType &&in) {
+    input_ = std::make_shared<InType>(std::move(in));
+  }
+
+  /// @brief Binds input data shared with the caller without copying it.
+  /// @param in Shared pointer to the input data.
+  /// @throws std::invalid_argument If the pointer is null.
+  void BindInput(std::shared_ptr<InType> in) {
+    if (!in) {
+      throw std::invalid_argument("Input pointer must not be null");
+    }
+    input_ = std::move(in);
+  }
+
+  /// @brief Borrows caller-owned input data without copying or owning it.
+  /// @param in Input data that must outlive the task.
+  void BorrowInput(InType &in) {
+    input_ = std::shared_ptr<InType>(std::shared_ptr<InType>{}, &in);
+  }
+
+  /// @brief Returns the input data as a shared pointer.
+  /// @return Shared pointer to the input (non-owning if the input was borrowed).
+  [[nodiscard]] std::shared_ptr<InType> GetSharedInput() const {
     return input_;
   }
 
+  /// @brief Returns the communicator of the task, a private duplicate of ppc::util::GetTaskParentComm().
+  /// @details MPI and ALL tasks create it in Validation(); other tasks on their first call, which is then collective.
+  /// @throws std::logic_error If MPI is not initialized.
+  MPI_Comm GetComm() {
+    return comm_.Get();
+  }
+
   /// @brief Returns a reference to the output data.
   /// @return Reference to the task's output data.
   OutType &GetOutput() {
@@ -204,14 +342,16 @@ class Task {
   }
 
   /// @brief Destructor. Verifies that the pipeline was executed in the correct order.
-  /// @note Terminates the program if the pipeline order is incorrect or incomplete.
+  /// @note Terminates the program if the pipeline order is incorrect or incomplete, or if the task left an unread
+  ///       message on its communicator.
   virtual ~Task() {
     if (stage_ != PipelineStage::kDone && stage_ != PipelineStage::kException) {
       ppc::util::DestructorFailureFlag::Set();
     }
-#if _OPENMP >= 201811
-    omp_pause_resource_all(omp_pause_soft);
-#endif
+    if (!comm_.Free()) {
+      ppc::util::DestructorFailureFlag::Set();
+    }
+    ppc::util::OnTaskFinished();
   }
 
  protected:
@@ -257,13 +397,53 @@ class Task {
   /// @return True if postprocessing is successful.
   virtual bool PostProcessingImpl() = 0;
 
+  /// @brief Saves task-specific state that RunImpl() mutates, e.g. buffers filled in preprocessing.
+  /// @note The default does nothing; override together with RestoreRunStateImpl().
+  virtual void SnapshotRunStateImpl() {}
+
+  /// @brief Restores task-specific state saved by SnapshotRunStateImpl().
+  virtual void RestoreRunStateImpl() {}
+
  private:
-  InType input_{};
+  /// @brief Runs a stage implementation, records its duration and, if tracing is enabled, its timeline event.
+  template <typename Impl>
+  bool TimedStage(const char *stage_name, StageStats &stage_stats, Impl impl) {
+    const bool trace = ppc::util::IsTracingEnabled();
+    const double trace_begin = trace ? ppc::util::TraceNowUs() : 0.0;
+    ppc::util::AllocationCounters allocations_before;
+    if constexpr (ppc::util::IsAllocationTrackingEnabled()) {
+      ppc::util::ResetAllocationPeak();
+      allocations_before = ppc::util::GetAllocationCounters();
+    }
+    if constexpr (ppc::util::IsMpiProfilingEnabled()) {
+      ppc::util::SetMpiProfileStage(stage_name);
+    }
+    const auto begin = std::chrono::high_resolution_clock::now();
+    const bool result = impl();
+    const auto duration =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - begin).count();
+    stage_stats.Record(static_cast<double>(duration) * 1e-9);
+    if constexpr (ppc::util::IsMpiProfilingEnabled()) {
+      ppc::util::SetMpiProfileStage(nullptr);
+    }
+    if constexpr (ppc::util::IsAllocationTrackingEnabled()) {
+      stage_stats.RecordAllocations(allocations_before, ppc::util::GetAllocationCounters());
+    }
+    if (trace) {
+      ppc::util::RecordTraceEvent(stage_name, TypeOfTaskToString(type_of_task_), trace_begin, ppc::util::TraceNowUs());
+    }
+    return result;
+  }
+
+  std::shared_ptr<InType> input_ = std::make_shared<InType>();
   OutType output_{};
+  std::optional<OutType> output_snapshot_;
   StateOfTesting state_of_testing_ = StateOfTesting::kFunc;
   TypeOfTask type_of_task_ = TypeOfTask::kUnknown;
   StatusOfTask status_of_task_ = StatusOfTask::kEnabled;
   std::chrono::high_resolution_clock::time_point tmp_time_point_;
+  TaskStats task_stats_;
+  ppc::util::TaskComm comm_;
   enum class PipelineStage : uint8_t {
     kNone,
     kValidation,
@@ -281,13 +461,15 @@ template <typename InType, typename OutType>
 using TaskPtr = std::shared_ptr<Task<InType, OutType>>;
 
 /// @brief Constructs and returns a shared pointer to a task with the given input.
+/// @details The input is moved into the task constructor, so tasks taking @p InType by value
+///          receive it without a copy.
 /// @tparam TaskType Type of the task to create.
 /// @tparam InType Type of the input.
 /// @param in Input to pass to the task constructor.
 /// @return Shared a pointer to the newly created task.
 template <typename TaskType, typename InType>
-std::shared_ptr<TaskType> TaskGetter(const InType &in) {
-  return std::make_shared<TaskType>(in);
+std::shared_ptr<TaskType> TaskGetter(InType in) {
+  return std::make_shared<TaskType>(std::move(in));
 }
 
 }  // namespace ppc::task
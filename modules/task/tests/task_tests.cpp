@@ -8,6 +8,7 @@
 #include <fstream>
 #include <libenvpp/env.hpp>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <system_error>
@@ -17,6 +18,9 @@
 
 #include "runners/include/runners.hpp"
 #include "task/include/task.hpp"
+#include "util/include/alloc_tracker.hpp"
+#include "util/include/settings.hpp"
+#include "util/include/task_comm.hpp"
 #include "util/include/util.hpp"
 
 using ppc::task::StateOfTesting;
@@ -229,6 +233,27 @@ TEST(TaskTest, GetStringTaskTypeThrowsIfKeyMissing) {
   EXPECT_ANY_THROW(GetStringTaskType(TypeOfTask::kSTL, path));
 }
 
+TEST(TaskTest, SettingsAreParsedOncePerPath) {
+  std::string path = "settings_cached.json";
+  ScopedFile cleaner(path);
+  {
+    std::ofstream file(path);
+    file << R"({"tasks": {"mpi": "enabled", "seq": "disabled"}, "tasks_type": "processes"})";
+  }
+  EXPECT_EQ(GetStringTaskType(TypeOfTask::kMPI, path), "mpi_enabled");
+  EXPECT_EQ(GetTaskStatus(TypeOfTask::kMPI, path), StatusOfTask::kEnabled);
+  EXPECT_EQ(GetTaskStatus(TypeOfTask::kSEQ, path), StatusOfTask::kDisabled);
+  EXPECT_EQ(ppc::util::GetTaskSettings(path).GetTasksType(), ppc::util::TasksType::kProcesses);
+
+  // Later changes of the file are not seen: the first parse is served from the cache
+  {
+    std::ofstream file(path);
+    file << R"({"tasks": {"mpi": "disabled"}, "tasks_type": "threads"})";
+  }
+  EXPECT_EQ(GetStringTaskType(TypeOfTask::kMPI, path), "mpi_enabled");
+  EXPECT_EQ(&ppc::util::GetTaskSettings(path), &ppc::util::GetTaskSettings(path));
+}
+
 TEST(TaskTest, TaskDestructorThrowsIfStageIncomplete) {
   {
     std::vector<int32_t> in(20, 1);
@@ -352,6 +377,207 @@ TEST(TaskTest, PostProcessingThrowsIfCalledBeforeRun) {
   EXPECT_THROW(task->PostProcessing(), std::runtime_error);
 }
 
+TEST(TaskTest, BindInputMovesWithoutCopy) {
+  std::vector<int32_t> in(20, 1);
+  const auto *data = in.data();
+  ppc::test::TestTask<std::vector<int32_t>, int32_t> task({});
+  task.BindInput(std::move(in));
+  EXPECT_EQ(task.GetInput().data(), data);
+  task.Validation();
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+  EXPECT_EQ(task.GetOutput(), 20);
+}
+
+TEST(TaskTest, BindInputSharesOwnership) {
+  auto in = std::make_shared<std::vector<int32_t>>(20, 1);
+  ppc::test::TestTask<std::vector<int32_t>, int32_t> task({});
+  task.BindInput(in);
+  EXPECT_EQ(&task.GetInput(), in.get());
+  EXPECT_EQ(task.GetSharedInput(), in);
+  EXPECT_EQ(in.use_count(), 2);
+  task.Validation();
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+  EXPECT_EQ(task.GetOutput(), 20);
+}
+
+TEST(TaskTest, BindInputThrowsOnNullPointer) {
+  ppc::test::TestTask<std::vector<int32_t>, int32_t> task({});
+  EXPECT_THROW(task.BindInput(std::shared_ptr<std::vector<int32_t>>{}), std::invalid_argument);
+  EXPECT_FALSE(task.Validation());
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+}
+
+TEST(TaskTest, BorrowInputDoesNotOwn) {
+  std::vector<int32_t> in(20, 1);
+  ppc::test::TestTask<std::vector<int32_t>, int32_t> task({});
+  task.BorrowInput(in);
+  EXPECT_EQ(&task.GetInput(), &in);
+  EXPECT_EQ(task.GetSharedInput().use_count(), 0);
+  task.Validation();
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+  EXPECT_EQ(task.GetOutput(), 20);
+}
+
+TEST(TaskTest, SpanInputBorrowsCallerData) {
+  std::vector<int32_t> data(20, 1);
+  const std::span<const int32_t> view(data);
+  ppc::test::TestTask<std::span<const int32_t>, int32_t> task(view);
+  EXPECT_EQ(task.GetInput().data(), data.data());
+  task.Validation();
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+  EXPECT_EQ(task.GetOutput(), 20);
+}
+
+class MoveOnlyInputTask : public Task<std::vector<int32_t>, int32_t> {
+ public:
+  explicit MoveOnlyInputTask(std::vector<int32_t> in) {
+    GetInput() = std::move(in);
+  }
+  bool ValidationImpl() override {
+    return true;
+  }
+  bool PreProcessingImpl() override {
+    return true;
+  }
+  bool RunImpl() override {
+    return true;
+  }
+  bool PostProcessingImpl() override {
+    return true;
+  }
+};
+
+TEST(TaskTest, TaskGetterMovesInputIntoTask) {
+  std::vector<int32_t> in(20, 1);
+  const auto *data = in.data();
+  auto task = ppc::task::TaskGetter<MoveOnlyInputTask>(std::move(in));
+  EXPECT_EQ(task->GetInput().data(), data);
+  task->Validation();
+  task->PreProcessing();
+  task->Run();
+  task->PostProcessing();
+}
+
+TEST(TaskTest, TaskStatsRecordEveryStage) {
+  std::vector<int32_t> in(20, 1);
+  ppc::test::TestTask<std::vector<int32_t>, int32_t> task(in);
+  task.GetStateOfTesting() = StateOfTesting::kPerf;
+  task.Validation();
+  task.PreProcessing();
+  task.Run();
+  task.Run();
+  task.PostProcessing();
+
+  const auto &stats = task.GetTaskStats();
+  EXPECT_EQ(stats.validation.calls, 1U);
+  EXPECT_EQ(stats.pre_processing.calls, 1U);
+  EXPECT_EQ(stats.run.calls, 2U);
+  EXPECT_EQ(stats.post_processing.calls, 1U);
+  EXPECT_LE(stats.run.min_sec, stats.run.max_sec);
+  EXPECT_GE(stats.run.total_sec, stats.run.min_sec + stats.run.max_sec);
+  EXPECT_DOUBLE_EQ(stats.run.MeanSec(), stats.run.total_sec / 2.0);
+
+  task.ResetTaskStats();
+  EXPECT_EQ(task.GetTaskStats().run.calls, 0U);
+  EXPECT_DOUBLE_EQ(task.GetTaskStats().run.MeanSec(), 0.0);
+}
+
+class AccumulatingTask : public Task<int, int> {
+ public:
+  int scratch = 0;
+
+ protected:
+  bool ValidationImpl() override {
+    return true;
+  }
+  bool PreProcessingImpl() override {
+    GetOutput() = 0;
+    scratch = 10;
+    return true;
+  }
+  bool RunImpl() override {
+    GetOutput() += GetInput();
+    scratch--;
+    return true;
+  }
+  bool PostProcessingImpl() override {
+    return true;
+  }
+  void SnapshotRunStateImpl() override {
+    scratch_snapshot_ = scratch;
+  }
+  void RestoreRunStateImpl() override {
+    scratch = scratch_snapshot_;
+  }
+
+ private:
+  int scratch_snapshot_ = 0;
+};
+
+TEST(TaskTest, RestoreRunStateUndoesRunSideEffects) {
+  AccumulatingTask task;
+  task.GetInput() = 3;
+  task.Validation();
+  task.PreProcessing();
+  task.SnapshotRunState();
+  task.Run();
+  task.Run();
+  EXPECT_EQ(task.GetOutput(), 6);
+  EXPECT_EQ(task.scratch, 8);
+
+  task.RestoreRunState();
+  EXPECT_EQ(task.GetOutput(), 0);
+  EXPECT_EQ(task.scratch, 10);
+  task.Run();
+  task.PostProcessing();
+  EXPECT_EQ(task.GetOutput(), 3);
+}
+
+TEST(TaskTest, StageStatsAccumulateAllocations) {
+  ppc::util::AllocationCounters start;
+  start.allocations = 10;
+  start.allocated_bytes = 100;
+  start.live_bytes = 50;
+  ppc::util::AllocationCounters middle;
+  middle.allocations = 13;
+  middle.allocated_bytes = 400;
+  middle.live_bytes = 60;
+  middle.peak_live_bytes = 250;
+  ppc::util::AllocationCounters end = middle;
+  end.allocations = 14;
+  end.allocated_bytes = 432;
+  end.peak_live_bytes = 92;
+
+  ppc::task::StageStats stats;
+  stats.RecordAllocations(start, middle);
+  stats.RecordAllocations(middle, end);
+  EXPECT_EQ(stats.allocations, 4U);
+  EXPECT_EQ(stats.allocated_bytes, 332U);
+  EXPECT_EQ(stats.peak_heap_bytes, 200U);
+}
+
+TEST(TaskTest, MpiTaskWithoutMpiHasNoCommunicator) {
+  DummyTask task;
+  task.SetTypeOfTask(TypeOfTask::kMPI);
+  // Without MPI_Init the validation skips the duplication instead of failing
+  EXPECT_TRUE(task.Validation());
+  EXPECT_THROW(task.GetComm(), std::logic_error);
+  EXPECT_EQ(ppc::util::GetTaskParentComm(), MPI_COMM_WORLD);
+  task.PreProcessing();
+  task.Run();
+  task.PostProcessing();
+}
+
 int main(int argc, char **argv) {
   return ppc::runners::SimpleInit(argc, argv);
 }
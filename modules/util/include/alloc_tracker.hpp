@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ppc::util {
+
+/// @brief Process-wide heap allocation counters maintained by the replaceable operator new/delete.
+struct AllocationCounters {
+  /// @brief Number of successful operator new calls.
+  uint64_t allocations = 0;
+  /// @brief Number of operator delete calls with a non-null pointer.
+  uint64_t deallocations = 0;
+  /// @brief Total number of bytes handed out by operator new.
+  uint64_t allocated_bytes = 0;
+  /// @brief Bytes currently allocated through operator new.
+  uint64_t live_bytes = 0;
+  /// @brief Highest value of live_bytes since the last ResetAllocationPeak() call.
+  uint64_t peak_live_bytes = 0;
+};
+
+/// @brief Returns true if the build replaces the global operator new/delete with counting versions.
+/// @details Enabled by configuring with -DENABLE_ALLOC_TRACKING=ON; otherwise all counters stay zero.
+constexpr bool IsAllocationTrackingEnabled() {
+#ifdef PPC_ALLOC_TRACKING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// @brief Returns a snapshot of the allocation counters of all threads.
+AllocationCounters GetAllocationCounters();
+
+/// @brief Restarts peak tracking from the currently live bytes.
+void ResetAllocationPeak();
+
+/// @brief Returns the peak resident set size of the process in bytes, or 0 if it is unknown.
+uint64_t GetPeakRssBytes();
+
+}  // namespace ppc::util
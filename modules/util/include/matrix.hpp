@@ -0,0 +1,301 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ppc::util {
+
+/// @brief Non-owning view of a rectangular part of a row-major matrix.
+/// @details Rows are cols() elements long and start stride() elements apart, so blocks of rows and tiles of any
+///          matrix are views without copies. Use MatrixView<const T> for read-only access.
+template <typename T>
+class MatrixView {
+ public:
+  MatrixView() = default;
+  MatrixView(T *data, std::size_t rows, std::size_t cols, std::size_t stride)
+      : data_(data), rows_(rows), cols_(cols), stride_(stride) {}
+
+  /// @brief Read-only views are created implicitly from writable ones.
+  template <typename U>
+    requires std::is_same_v<const U, T> && (!std::is_same_v<U, T>)
+  MatrixView(const MatrixView<U> &other)  // NOLINT(google-explicit-constructor)
+      : MatrixView(other.Data(), other.Rows(), other.Cols(), other.Stride()) {}
+
+  [[nodiscard]] T *Data() const {
+    return data_;
+  }
+  [[nodiscard]] std::size_t Rows() const {
+    return rows_;
+  }
+  [[nodiscard]] std::size_t Cols() const {
+    return cols_;
+  }
+  /// @brief Distance between the starts of consecutive rows in elements.
+  [[nodiscard]] std::size_t Stride() const {
+    return stride_;
+  }
+  [[nodiscard]] bool Empty() const {
+    return rows_ == 0 || cols_ == 0;
+  }
+  /// @brief Returns true if the rows follow each other without gaps, i.e. the view is one span of Rows() * Cols().
+  [[nodiscard]] bool IsContiguous() const {
+    return stride_ == cols_ || rows_ <= 1;
+  }
+
+  T &operator()(std::size_t row, std::size_t col) const {
+    return data_[(row * stride_) + col];
+  }
+
+  [[nodiscard]] std::span<T> Row(std::size_t row) const {
+    return {data_ + (row * stride_), cols_};
+  }
+
+  /// @brief Returns rows [row_begin, row_begin + row_count).
+  /// @throws std::out_of_range If the rows are outside of the view.
+  [[nodiscard]] MatrixView Block(std::size_t row_begin, std::size_t row_count) const {
+    return Tile(row_begin, 0, row_count, cols_);
+  }
+
+  /// @brief Returns the tile of tile_rows x tile_cols elements whose top-left element is (row, col).
+  /// @throws std::out_of_range If the tile is outside of the view.
+  [[nodiscard]] MatrixView Tile(std::size_t row, std::size_t col, std::size_t tile_rows, std::size_t tile_cols) const {
+    if (row + tile_rows > rows_ || col + tile_cols > cols_) {
+      throw std::out_of_range("Matrix tile exceeds the view");
+    }
+    return {data_ + (row * stride_) + col, tile_rows, tile_cols, stride_};
+  }
+
+ private:
+  T *data_ = nullptr;
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t stride_ = 0;
+};
+
+/// @brief Row-major matrix in a single allocation aligned for SIMD loads.
+/// @details By default the rows are packed, so the whole matrix is one contiguous buffer that MPI sends without
+///          copies. With padded rows every row starts on an alignment boundary instead. Elements must be trivially
+///          copyable, since the MPI helpers transfer them as bytes.
+template <typename T>
+class Matrix {
+  static_assert(std::is_trivially_copyable_v<T>, "Matrix elements must be trivially copyable");
+
+ public:
+  /// @brief Alignment of the allocation and of padded rows in bytes (one cache line).
+  static constexpr std::size_t kAlignment = 64;
+
+  Matrix() = default;
+
+  /// @param pad_rows Start every row on a kAlignment boundary; otherwise the rows are packed.
+  Matrix(std::size_t rows, std::size_t cols, const T &value = T{}, bool pad_rows = false)
+      : rows_(rows), cols_(cols), stride_(pad_rows ? PaddedStride(cols) : cols), data_(Allocate(rows_ * stride_)) {
+    std::uninitialized_fill_n(data_.get(), rows_ * stride_, value);
+  }
+
+  /// @brief Copies nested rows into a packed matrix.
+  /// @throws std::invalid_argument If the rows differ in length.
+  static Matrix FromRows(const std::vector<std::vector<T>> &rows) {
+    const std::size_t cols = rows.empty() ? 0 : rows.front().size();
+    Matrix matrix(rows.size(), cols);
+    for (std::size_t row = 0; row < rows.size(); row++) {
+      if (rows[row].size() != cols) {
+        throw std::invalid_argument("Matrix rows must have the same length");
+      }
+      std::ranges::copy(rows[row], matrix.Row(row).begin());
+    }
+    return matrix;
+  }
+
+  /// @brief Copies the matrix into nested rows.
+  [[nodiscard]] std::vector<std::vector<T>> ToRows() const {
+    std::vector<std::vector<T>> rows(rows_);
+    for (std::size_t row = 0; row < rows_; row++) {
+      const auto source = Row(row);
+      rows[row].assign(source.begin(), source.end());
+    }
+    return rows;
+  }
+
+  Matrix(const Matrix &other)
+      : rows_(other.rows_), cols_(other.cols_), stride_(other.stride_), data_(Allocate(rows_ * stride_)) {
+    std::uninitialized_copy_n(other.data_.get(), rows_ * stride_, data_.get());
+  }
+  Matrix &operator=(const Matrix &other) {
+    if (this != &other) {
+      Matrix copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+  Matrix(Matrix &&other) noexcept
+      : rows_(std::exchange(other.rows_, 0)),
+        cols_(std::exchange(other.cols_, 0)),
+        stride_(std::exchange(other.stride_, 0)),
+        data_(std::move(other.data_)) {}
+  Matrix &operator=(Matrix &&other) noexcept {
+    rows_ = std::exchange(other.rows_, 0);
+    cols_ = std::exchange(other.cols_, 0);
+    stride_ = std::exchange(other.stride_, 0);
+    data_ = std::move(other.data_);
+    return *this;
+  }
+  ~Matrix() = default;
+
+  [[nodiscard]] std::size_t Rows() const {
+    return rows_;
+  }
+  [[nodiscard]] std::size_t Cols() const {
+    return cols_;
+  }
+  [[nodiscard]] std::size_t Stride() const {
+    return stride_;
+  }
+  [[nodiscard]] bool Empty() const {
+    return rows_ == 0 || cols_ == 0;
+  }
+  [[nodiscard]] T *Data() {
+    return data_.get();
+  }
+  [[nodiscard]] const T *Data() const {
+    return data_.get();
+  }
+
+  T &operator()(std::size_t row, std::size_t col) {
+    return data_[(row * stride_) + col];
+  }
+  const T &operator()(std::size_t row, std::size_t col) const {
+    return data_[(row * stride_) + col];
+  }
+
+  [[nodiscard]] std::span<T> Row(std::size_t row) {
+    return View().Row(row);
+  }
+  [[nodiscard]] std::span<const T> Row(std::size_t row) const {
+    return View().Row(row);
+  }
+
+  [[nodiscard]] MatrixView<T> View() {
+    return {data_.get(), rows_, cols_, stride_};
+  }
+  [[nodiscard]] MatrixView<const T> View() const {
+    return {data_.get(), rows_, cols_, stride_};
+  }
+  [[nodiscard]] MatrixView<T> Block(std::size_t row_begin, std::size_t row_count) {
+    return View().Block(row_begin, row_count);
+  }
+  [[nodiscard]] MatrixView<const T> Block(std::size_t row_begin, std::size_t row_count) const {
+    return View().Block(row_begin, row_count);
+  }
+  [[nodiscard]] MatrixView<T> Tile(std::size_t row, std::size_t col, std::size_t tile_rows, std::size_t tile_cols) {
+    return View().Tile(row, col, tile_rows, tile_cols);
+  }
+  [[nodiscard]] MatrixView<const T> Tile(std::size_t row, std::size_t col, std::size_t tile_rows,
+                                         std::size_t tile_cols) const {
+    return View().Tile(row, col, tile_rows, tile_cols);
+  }
+
+  /// @brief Compares the shapes and the elements; the padding is ignored.
+  friend bool operator==(const Matrix &lhs, const Matrix &rhs) {
+    if (lhs.rows_ != rhs.rows_ || lhs.cols_ != rhs.cols_) {
+      return false;
+    }
+    for (std::size_t row = 0; row < lhs.rows_; row++) {
+      if (!std::ranges::equal(lhs.Row(row), rhs.Row(row))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct AlignedDelete {
+    void operator()(T *data) const {
+      ::operator delete[](data, std::align_val_t{kAlignment});
+    }
+  };
+
+  static std::size_t PaddedStride(std::size_t cols) {
+    constexpr std::size_t kStep = std::max<std::size_t>(1, kAlignment / sizeof(T));
+    return ((cols + kStep - 1) / kStep) * kStep;
+  }
+
+  static std::unique_ptr<T[], AlignedDelete> Allocate(std::size_t size) {
+    if (size == 0) {
+      return nullptr;
+    }
+    return std::unique_ptr<T[], AlignedDelete>(
+        static_cast<T *>(::operator new[](size * sizeof(T), std::align_val_t{kAlignment})));
+  }
+
+  std::size_t rows_ = 0;
+  std::size_t cols_ = 0;
+  std::size_t stride_ = 0;
+  std::unique_ptr<T[], AlignedDelete> data_;
+};
+
+/// @brief Committed MPI datatype of one row of a matrix view; a count of N transfers N consecutive rows.
+/// @details The row is described in bytes and its extent is the row stride, so packed matrices, padded matrices
+///          and tiles are all sent without intermediate buffers.
+class MatrixRowType {
+ public:
+  MatrixRowType(std::size_t row_bytes, std::size_t stride_bytes);
+  template <typename T>
+  explicit MatrixRowType(const MatrixView<T> &view)
+      : MatrixRowType(view.Cols() * sizeof(T), view.Stride() * sizeof(T)) {}
+  ~MatrixRowType();
+
+  MatrixRowType(const MatrixRowType &) = delete;
+  MatrixRowType &operator=(const MatrixRowType &) = delete;
+  MatrixRowType(MatrixRowType &&) = delete;
+  MatrixRowType &operator=(MatrixRowType &&) = delete;
+
+  [[nodiscard]] MPI_Datatype Get() const {
+    return type_;
+  }
+
+ private:
+  MPI_Datatype type_ = MPI_DATATYPE_NULL;
+};
+
+/// @brief Converts a row count to an MPI count.
+/// @throws std::overflow_error If the count exceeds the int range.
+int ToMpiRowCount(std::size_t rows);
+
+/// @brief Sends the rows of a view with MPI_Send.
+template <typename T>
+void SendMatrix(MatrixView<const T> view, int dest, int tag, MPI_Comm comm) {
+  const MatrixRowType row_type(view);
+  MPI_Send(view.Data(), ToMpiRowCount(view.Rows()), row_type.Get(), dest, tag, comm);
+}
+
+/// @brief Receives rows into a view of the expected shape with MPI_Recv.
+/// @throws std::runtime_error If the message has a different number of rows.
+template <typename T>
+void RecvMatrix(MatrixView<T> view, int source, int tag, MPI_Comm comm) {
+  const MatrixRowType row_type(view);
+  MPI_Status status;
+  MPI_Recv(view.Data(), ToMpiRowCount(view.Rows()), row_type.Get(), source, tag, comm, &status);
+  int received_rows = 0;
+  MPI_Get_count(&status, row_type.Get(), &received_rows);
+  if (static_cast<std::size_t>(received_rows) != view.Rows()) {
+    throw std::runtime_error("Received a matrix with an unexpected number of rows");
+  }
+}
+
+/// @brief Broadcasts the rows of a view; every rank passes a view of the same shape.
+template <typename T>
+void BcastMatrix(MatrixView<T> view, int root, MPI_Comm comm) {
+  const MatrixRowType row_type(view);
+  MPI_Bcast(view.Data(), ToMpiRowCount(view.Rows()), row_type.Get(), root, comm);
+}
+
+}  // namespace ppc::util
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ppc::util::mpi {
+
+/// @brief Maps a C++ type to its predefined MPI datatype; specialized for the arithmetic types.
+template <typename T>
+struct MpiType;
+
+#define PPC_MPI_TYPE(cpp_type, mpi_type) \
+  template <>                            \
+  struct MpiType<cpp_type> {             \
+    static MPI_Datatype Get() {          \
+      return mpi_type;                   \
+    }                                    \
+  }
+
+PPC_MPI_TYPE(char, MPI_CHAR);
+PPC_MPI_TYPE(signed char, MPI_SIGNED_CHAR);
+PPC_MPI_TYPE(unsigned char, MPI_UNSIGNED_CHAR);
+PPC_MPI_TYPE(short, MPI_SHORT);
+PPC_MPI_TYPE(unsigned short, MPI_UNSIGNED_SHORT);
+PPC_MPI_TYPE(int, MPI_INT);
+PPC_MPI_TYPE(unsigned, MPI_UNSIGNED);
+PPC_MPI_TYPE(long, MPI_LONG);
+PPC_MPI_TYPE(unsigned long, MPI_UNSIGNED_LONG);
+PPC_MPI_TYPE(long long, MPI_LONG_LONG);
+PPC_MPI_TYPE(unsigned long long, MPI_UNSIGNED_LONG_LONG);
+PPC_MPI_TYPE(float, MPI_FLOAT);
+PPC_MPI_TYPE(double, MPI_DOUBLE);
+PPC_MPI_TYPE(long double, MPI_LONG_DOUBLE);
+PPC_MPI_TYPE(bool, MPI_CXX_BOOL);
+
+#undef PPC_MPI_TYPE
+
+/// @brief Returns the MPI datatype of T, ignoring const and volatile.
+template <typename T>
+MPI_Datatype GetMpiType() {
+  return MpiType<std::remove_cv_t<T>>::Get();
+}
+
+/// @brief Balanced block distribution of a range over the ranks of a communicator.
+/// @details Part p owns Count(p) consecutive units starting at Offset(p); the first Total() % Parts() parts own one
+///          unit more than the others. With a halo, every part additionally receives up to halo units on each side
+///          of its block (clipped at the ends of the range), e.g. the neighbour values of a stencil.
+class BlockPartition {
+ public:
+  /// @param total Number of units to distribute.
+  /// @param parts Number of parts, usually the communicator size; at least 1.
+  /// @param halo Units added on both sides of every block in the halo layout.
+  /// @param unit_size Elements per unit, e.g. the columns of a matrix distributed by rows; every count and offset
+  ///        is reported in elements.
+  /// @throws std::invalid_argument If parts or unit_size is not positive.
+  /// @throws std::overflow_error If a count or displacement exceeds the int range of MPI.
+  BlockPartition(std::size_t total, int parts, std::size_t halo = 0, std::size_t unit_size = 1);
+
+  [[nodiscard]] int Parts() const {
+    return static_cast<int>(counts_.size());
+  }
+  /// @brief Number of elements of the whole range.
+  [[nodiscard]] std::size_t Total() const {
+    return total_;
+  }
+  /// @brief Elements owned by a part.
+  [[nodiscard]] std::size_t Count(int part) const;
+  /// @brief Position of the first owned element of a part in the range.
+  [[nodiscard]] std::size_t Offset(int part) const;
+  /// @brief Elements of a part including its halo.
+  [[nodiscard]] std::size_t HaloCount(int part) const;
+  /// @brief Position of the first halo element of a part in the range.
+  [[nodiscard]] std::size_t HaloOffset(int part) const;
+  /// @brief Owned elements of owner that lie in the halo block of part, as the position of the first one in the
+  ///        range and their number; none for part == owner.
+  [[nodiscard]] std::pair<std::size_t, std::size_t> HaloShare(int part, int owner) const;
+  /// @brief Largest distance between a part and an owner of elements in its halo block; 0 without a halo.
+  [[nodiscard]] int HaloReach() const;
+
+  /// @brief Owned counts and displacements as MPI ints.
+  [[nodiscard]] const std::vector<int> &Counts() const;
+  [[nodiscard]] const std::vector<int> &Displs() const;
+  /// @brief Counts and displacements of the halo layout; blocks of neighbouring parts overlap.
+  [[nodiscard]] const std::vector<int> &HaloCounts() const;
+  [[nodiscard]] const std::vector<int> &HaloDispls() const;
+
+ private:
+  std::size_t total_ = 0;
+  std::vector<int> counts_;
+  std::vector<int> displs_;
+  std::vector<int> halo_counts_;
+  std::vector<int> halo_displs_;
+  int halo_reach_ = 0;
+};
+
+/// @brief Fills the halo of the block of the calling rank from the ranks that own those elements.
+/// @param local Block of the calling rank in the halo layout with its owned part already in place.
+/// @details Every rank exchanges with MPI_Sendrecv only the ranks within HaloReach() of it, usually its two
+///          neighbours.
+template <typename T>
+void ExchangeHalo(std::span<T> local, const BlockPartition &partition, MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  const std::size_t base = partition.HaloOffset(rank);
+  // Sends the owned elements that to needs and receives the elements of from that the calling rank needs
+  auto shift = [&](int to, int from) {
+    T *send_data = nullptr;
+    std::size_t send_count = 0;
+    if (to >= 0 && to < partition.Parts()) {
+      const auto [first, count] = partition.HaloShare(to, rank);
+      send_data = local.data() + (first - base);
+      send_count = count;
+    } else {
+      to = MPI_PROC_NULL;
+    }
+    T *recv_data = nullptr;
+    std::size_t recv_count = 0;
+    if (from >= 0 && from < partition.Parts()) {
+      const auto [first, count] = partition.HaloShare(rank, from);
+      recv_data = local.data() + (first - base);
+      recv_count = count;
+    } else {
+      from = MPI_PROC_NULL;
+    }
+    MPI_Sendrecv(send_data, static_cast<int>(send_count), GetMpiType<T>(), to, 0, recv_data,
+                 static_cast<int>(recv_count), GetMpiType<T>(), from, 0, comm, MPI_STATUS_IGNORE);
+  };
+  const int reach = partition.HaloReach();
+  for (int distance = 1; distance <= reach; distance++) {
+    shift(rank + distance, rank - distance);
+    shift(rank - distance, rank + distance);
+  }
+}
+
+/// @brief Distributes the halo layout of a partition, writing straight into recv.
+/// @details The owned blocks go out with one MPI_Scatterv, which must not send an element twice, and
+///          ExchangeHalo() then fills the halos from the neighbouring ranks.
+/// @param send Whole range; read only on the root.
+/// @param recv Receives HaloCount(rank) elements (equal to Count(rank) without a halo).
+/// @throws std::invalid_argument If recv is smaller than the block of the calling rank.
+template <typename T>
+void ScatterBalanced(std::span<const T> send, std::span<T> recv, const BlockPartition &partition, int root,
+                     MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  if (recv.size() < partition.HaloCount(rank)) {
+    throw std::invalid_argument("Receive buffer is smaller than the block of the rank");
+  }
+  const std::size_t skip = partition.Offset(rank) - partition.HaloOffset(rank);
+  MPI_Scatterv(send.data(), partition.Counts().data(), partition.Displs().data(), GetMpiType<T>(),
+               recv.data() + skip, partition.Counts()[static_cast<std::size_t>(rank)], GetMpiType<T>(), root, comm);
+  if (partition.HaloReach() > 0) {
+    ExchangeHalo(recv, partition, comm);
+  }
+}
+
+/// @brief Distributes the halo layout of a partition and returns the block of the calling rank.
+template <typename T>
+std::vector<T> ScatterBalanced(std::span<const T> send, const BlockPartition &partition, int root, MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  std::vector<T> local(partition.HaloCount(rank));
+  ScatterBalanced(send, std::span<T>(local), partition, root, comm);
+  return local;
+}
+
+/// @brief Collects the owned elements of every rank on the root with one MPI_Gatherv.
+/// @param local Block of the calling rank in the halo layout; only its owned part is sent.
+/// @param recv Whole range; written only on the root.
+template <typename T>
+void GatherBalanced(std::span<const T> local, std::span<T> recv, const BlockPartition &partition, int root,
+                    MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  const std::size_t skip = partition.Offset(rank) - partition.HaloOffset(rank);
+  MPI_Gatherv(local.data() + skip, partition.Counts()[static_cast<std::size_t>(rank)], GetMpiType<T>(), recv.data(),
+              partition.Counts().data(), partition.Displs().data(), GetMpiType<T>(), root, comm);
+}
+
+/// @brief Collects the owned elements of every rank on every rank with one MPI_Allgatherv.
+/// @param local Block of the calling rank in the halo layout; only its owned part is sent.
+/// @param recv Whole range on every rank.
+template <typename T>
+void AllgatherBalanced(std::span<const T> local, std::span<T> recv, const BlockPartition &partition, MPI_Comm comm) {
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  const std::size_t skip = partition.Offset(rank) - partition.HaloOffset(rank);
+  MPI_Allgatherv(local.data() + skip, partition.Counts()[static_cast<std::size_t>(rank)], GetMpiType<T>(),
+                 recv.data(), partition.Counts().data(), partition.Displs().data(), GetMpiType<T>(), comm);
+}
+
+}  // namespace ppc::util::mpi
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ppc::util {
+
+/// @brief Accumulated MPI traffic of one function towards one peer within one task stage.
+struct MpiProfileEntry {
+  /// @brief Task stage during which the calls were made, e.g. "run".
+  std::string stage;
+  /// @brief Intercepted MPI function, e.g. "MPI_Send".
+  std::string function;
+  /// @brief Rank in MPI_COMM_WORLD of the point-to-point partner or collective root; -1 if there is none.
+  int peer = -1;
+  /// @brief True if the bytes were sent to the peer (used for the communication matrix).
+  bool sends = false;
+  /// @brief Number of calls; the receive half of MPI_Sendrecv adds bytes only, so a call is counted once.
+  uint64_t calls = 0;
+  /// @brief Payload bytes this rank sent or received in the calls.
+  uint64_t bytes = 0;
+  /// @brief Time spent inside the calls in seconds.
+  double time_sec = 0.0;
+};
+
+/// @brief Returns true if the build intercepts MPI calls through the PMPI profiling interface.
+/// @details Enabled by configuring with -DENABLE_MPI_PROFILING=ON; otherwise no calls are recorded.
+constexpr bool IsMpiProfilingEnabled() {
+#ifdef PPC_MPI_PROFILING
+  return true;
+#else
+  return false;
+#endif
+}
+
+/// @brief Sets the task stage that subsequent MPI calls are attributed to.
+/// @param stage Stage name with static storage duration, or nullptr to stop recording.
+void SetMpiProfileStage(const char *stage);
+
+/// @brief Removes the recorded MPI calls of this process and returns them.
+std::vector<MpiProfileEntry> TakeMpiProfile();
+
+}  // namespace ppc::util
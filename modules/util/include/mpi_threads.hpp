@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ppc::util {
+
+/// @brief MPI thread support levels in increasing order, mirroring MPI_THREAD_SINGLE ... MPI_THREAD_MULTIPLE.
+enum class MpiThreadLevel : uint8_t {
+  /// Only one thread exists in the process
+  kSingle,
+  /// Only the thread that initialized MPI makes MPI calls
+  kFunneled,
+  /// Any thread may make MPI calls, but only one at a time
+  kSerialized,
+  /// Any thread may make MPI calls at any time
+  kMultiple,
+};
+
+/// @brief Parses "single", "funneled", "serialized" or "multiple".
+/// @throws std::invalid_argument If the name is not one of the four levels.
+MpiThreadLevel ParseMpiThreadLevel(std::string_view name);
+
+/// @brief Returns the name accepted by ParseMpiThreadLevel().
+std::string_view MpiThreadLevelName(MpiThreadLevel level);
+
+/// @brief Converts a level to the MPI_THREAD_* constant.
+int ToMpiThreadConstant(MpiThreadLevel level);
+
+/// @brief Converts an MPI_THREAD_* constant to a level.
+MpiThreadLevel FromMpiThreadConstant(int provided);
+
+/// @brief Returns the level the runners request from MPI_Init_thread(), PPC_MPI_THREAD_LEVEL.
+/// @throws std::invalid_argument If the variable holds an unknown level.
+MpiThreadLevel GetRequestedMpiThreadLevel();
+
+/// @brief Returns the level provided by the MPI library (MPI_Query_thread), or kSingle before MPI_Init.
+MpiThreadLevel GetMpiThreadLevel();
+
+}  // namespace ppc::util
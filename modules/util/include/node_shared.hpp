@@ -0,0 +1,153 @@
+#pragma once
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "util/include/mpi_collectives.hpp"
+
+namespace ppc::util::mpi {
+
+/// @brief MPI-3 shared-memory window holding one buffer per node of a communicator.
+/// @details The ranks of every node share one allocation made by their node leader; the root of the communicator
+///          leads its own node. Ranks access the buffer directly instead of receiving private copies, and only the
+///          leaders exchange data between nodes.
+class SharedWindow {
+ public:
+  /// @brief Collective over comm: allocates bytes on every node.
+  SharedWindow(std::size_t bytes, int root, MPI_Comm comm);
+  ~SharedWindow();
+
+  SharedWindow(const SharedWindow &) = delete;
+  SharedWindow &operator=(const SharedWindow &) = delete;
+  SharedWindow(SharedWindow &&) = delete;
+  SharedWindow &operator=(SharedWindow &&) = delete;
+
+  [[nodiscard]] std::byte *Data() const {
+    return data_;
+  }
+  [[nodiscard]] std::size_t Bytes() const {
+    return bytes_;
+  }
+  [[nodiscard]] bool IsLeader() const {
+    return leader_comm_ != MPI_COMM_NULL;
+  }
+  [[nodiscard]] int NumNodes() const {
+    return num_nodes_;
+  }
+
+  /// @brief Collective over comm: makes the writes of all ranks of a node visible to the other ranks of the node.
+  void Sync() const;
+
+  /// @brief Collective over comm: copies the buffer of the root node to the other nodes, then synchronizes.
+  void BcastFromRoot() const;
+
+  /// @brief Collective over comm: every node receives the byte ranges written by the ranks of the other nodes.
+  /// @param offsets Start of the range written by each rank of comm.
+  /// @param counts Length of the range written by each rank of comm.
+  void AllgatherRanges(std::span<const std::size_t> offsets, std::span<const std::size_t> counts) const;
+
+ private:
+  MPI_Comm node_comm_ = MPI_COMM_NULL;
+  MPI_Comm leader_comm_ = MPI_COMM_NULL;
+  MPI_Win win_ = MPI_WIN_NULL;
+  std::byte *data_ = nullptr;
+  std::size_t bytes_ = 0;
+  int num_nodes_ = 1;
+  /// Rank of the node leader of every rank of comm in the leader communicator
+  std::vector<int> node_of_rank_;
+};
+
+/// @brief Array of T stored once per node in a SharedWindow.
+/// @details Input that the root holds is placed once per node and read by all ranks without copies. For output,
+///          every rank writes its block in place and AllgatherBlocks() completes the array on every node.
+template <typename T>
+class NodeSharedArray {
+  static_assert(std::is_trivially_copyable_v<T>, "Node-shared elements must be trivially copyable");
+
+ public:
+  /// @brief Collective over comm: allocates size elements per node.
+  NodeSharedArray(std::size_t size, int root, MPI_Comm comm) : size_(size), window_(size * sizeof(T), root, comm) {}
+
+  /// @brief Collective over comm: shares the data of the root with every rank.
+  /// @param data_at_root Elements to share; read only on the root.
+  NodeSharedArray(std::span<const T> data_at_root, int root, MPI_Comm comm)
+      : NodeSharedArray(BcastSize(data_at_root.size(), root, comm), root, comm) {
+    int rank = 0;
+    MPI_Comm_rank(comm, &rank);
+    if (rank == root && size_ > 0) {
+      std::ranges::copy(data_at_root, Span().begin());
+    }
+    window_.BcastFromRoot();
+  }
+
+  /// @brief Writable elements; writes become visible to other ranks after Sync() or AllgatherBlocks().
+  [[nodiscard]] std::span<T> Span() {
+    return {reinterpret_cast<T *>(window_.Data()), size_};
+  }
+  [[nodiscard]] std::span<const T> Span() const {
+    return {reinterpret_cast<const T *>(window_.Data()), size_};
+  }
+  [[nodiscard]] std::size_t Size() const {
+    return size_;
+  }
+
+  /// @brief Collective: publishes the writes of every rank within its node.
+  void Sync() const {
+    window_.Sync();
+  }
+
+  /// @brief Collective: after each rank has written its owned block of the partition, completes the array on
+  ///        every node.
+  void AllgatherBlocks(const BlockPartition &partition) const {
+    std::vector<std::size_t> offsets(static_cast<std::size_t>(partition.Parts()));
+    std::vector<std::size_t> counts(offsets.size());
+    for (int part = 0; part < partition.Parts(); part++) {
+      offsets[static_cast<std::size_t>(part)] = partition.Offset(part) * sizeof(T);
+      counts[static_cast<std::size_t>(part)] = partition.Count(part) * sizeof(T);
+    }
+    window_.AllgatherRanges(offsets, counts);
+  }
+
+ private:
+  static std::size_t BcastSize(std::size_t size, int root, MPI_Comm comm) {
+    auto value = static_cast<std::uint64_t>(size);
+    MPI_Bcast(&value, 1, MPI_UINT64_T, root, comm);
+    return static_cast<std::size_t>(value);
+  }
+
+  std::size_t size_;
+  SharedWindow window_;
+};
+
+/// @brief Makes the SharedWindow objects created during its lifetime treat the even and the odd ranks as two nodes
+///        instead of grouping ranks by the machine they run on. Scopes nest.
+/// @details Lets tests on a single machine exercise the transfers between node leaders.
+class ScopedParityNodes {
+ public:
+  ScopedParityNodes();
+  ~ScopedParityNodes();
+
+  ScopedParityNodes(const ScopedParityNodes &) = delete;
+  ScopedParityNodes &operator=(const ScopedParityNodes &) = delete;
+  ScopedParityNodes(ScopedParityNodes &&) = delete;
+  ScopedParityNodes &operator=(ScopedParityNodes &&) = delete;
+
+ private:
+  bool previous_;
+};
+
+/// @brief Collective over MPI_COMM_WORLD: counts the ranks that share the node of the calling rank.
+/// @details Called once by the test runner after MPI initialization; later calls of GetWorldRanksOnNode() return
+///          the count without communicating.
+void CountWorldRanksOnNode();
+
+/// @brief Number of MPI_COMM_WORLD ranks on the node of the calling rank; 1 before CountWorldRanksOnNode().
+int GetWorldRanksOnNode();
+
+}  // namespace ppc::util::mpi
@@ -3,16 +3,23 @@
 #include <gtest/gtest.h>
 #include <omp.h>
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "performance/include/performance.hpp"
 #include "task/include/task.hpp"
@@ -21,11 +28,21 @@
 namespace ppc::util {
 
 double GetTimeMPI();
+/// @note GetMPIRank(), BarrierMPI() and AllGatherMPI() work on the task parent communicator, i.e. the runner group.
 int GetMPIRank();
+void BarrierMPI();
+std::vector<double> AllGatherMPI(const std::vector<double> &values);
+/// @brief Returns the error message of rank 0 on every rank; empty if rank 0 succeeded.
+std::string BcastErrorMPI(const std::string &error);
 
 template <typename InType, typename OutType>
-using PerfTestParam = std::tuple<std::function<ppc::task::TaskPtr<InType, OutType>(InType)>, std::string,
-                                 ppc::performance::PerfResults::TypeOfRunning>;
+using PerfTaskGetter = std::function<ppc::task::TaskPtr<InType, OutType>(InType)>;
+
+/// @brief Perf test parameter: task getter, test name, type of running and the getter of the SEQ
+///        implementation of the same task (empty if there is none) used as the thread-sweep reference.
+template <typename InType, typename OutType>
+using PerfTestParam = std::tuple<PerfTaskGetter<InType, OutType>, std::string,
+                                 ppc::performance::PerfResults::TypeOfRunning, PerfTaskGetter<InType, OutType>>;
 
 template <typename InType, typename OutType>
 /// @brief Base class for performance testing of parallel tasks.
@@ -43,13 +60,26 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
  protected:
   virtual bool CheckTestOutputData(OutType &output_data) = 0;
   /// @brief Supplies input data for performance testing.
+  /// @note The returned value is moved into the task, so fixtures that no longer need the data
+  ///       after SetUp() may return it with std::move to avoid duplicating large inputs.
   virtual InType GetTestInputData() = 0;
+  /// @brief Problem sizes measured by the size sweep (PPC_PERF_SIZE_SWEEP); empty disables the sweep.
+  virtual std::vector<std::size_t> GetTestInputSizes() {
+    return {};
+  }
+  /// @brief Supplies input data of the given problem size for the size sweep.
+  /// @note Must be overridden by fixtures that return a non-empty GetTestInputSizes().
+  virtual InType GetTestInputDataOfSize(std::size_t /*size*/) {
+    throw std::runtime_error("GetTestInputDataOfSize() is not implemented by the fixture.");
+  }
 
   virtual void SetPerfAttributes(ppc::performance::PerfAttr &perf_attrs) {
     if (task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kMPI ||
         task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kALL) {
       const double t0 = GetTimeMPI();
       perf_attrs.current_timer = [t0] { return GetTimeMPI() - t0; };
+      perf_attrs.barrier = BarrierMPI;
+      perf_attrs.all_gather = AllGatherMPI;
     } else if (task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kOMP) {
       const double t0 = omp_get_wtime();
       perf_attrs.current_timer = [t0] { return omp_get_wtime() - t0; };
@@ -57,7 +87,7 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
                task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kSTL ||
                task_->GetDynamicTypeOfTask() == ppc::task::TypeOfTask::kTBB) {
       const auto t0 = std::chrono::high_resolution_clock::now();
-      perf_attrs.current_timer = [&] {
+      perf_attrs.current_timer = [t0] {
         auto now = std::chrono::high_resolution_clock::now();
         auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - t0).count();
         return static_cast<double>(ns) * 1e-9;
@@ -65,12 +95,17 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
     } else {
       throw std::runtime_error("The task type is not supported for performance testing.");
     }
+    perf_attrs.num_warmup = static_cast<uint64_t>(std::max(0, GetPerfWarmupRuns()));
+    perf_attrs.adaptive = IsPerfAdaptive();
+    perf_attrs.cold_cache = IsPerfColdCache();
+    perf_attrs.hardware_counters = IsPerfHardwareCounters();
   }
 
   void ExecuteTest(const PerfTestParam<InType, OutType> &perf_test_param) {
     auto task_getter = std::get<static_cast<std::size_t>(GTestParamIndex::kTaskGetter)>(perf_test_param);
     auto test_name = std::get<static_cast<std::size_t>(GTestParamIndex::kNameTest)>(perf_test_param);
     auto mode = std::get<static_cast<std::size_t>(GTestParamIndex::kTestParams)>(perf_test_param);
+    auto reference_getter = std::get<static_cast<std::size_t>(GTestParamIndex::kReferenceTaskGetter)>(perf_test_param);
 
     ASSERT_FALSE(test_name.find("unknown") != std::string::npos);
     if (test_name.find("disabled") != std::string::npos) {
@@ -80,41 +115,171 @@ class BaseRunPerfTests : public ::testing::TestWithParam<PerfTestParam<InType, O
     const auto test_env_scope = ppc::util::test::MakePerTestEnvForCurrentGTest(test_name);
 
     task_ = task_getter(GetTestInputData());
+    std::string error;
+    {
+      // Perf shares the task, so it is destroyed before the sweeps can release the input of the task
+      ppc::performance::Perf perf(task_);
+      ppc::performance::PerfAttr perf_attr;
+      SetPerfAttributes(perf_attr);
+
+      if (mode == ppc::performance::PerfResults::TypeOfRunning::kPipeline) {
+        perf.PipelineRun(perf_attr);
+      } else if (mode == ppc::performance::PerfResults::TypeOfRunning::kTaskRun) {
+        perf.TaskRun(perf_attr);
+      } else {
+        std::stringstream err_msg;
+        err_msg << '\n' << "The type of performance check for the task was not selected.\n";
+        throw std::runtime_error(err_msg.str().c_str());
+      }
+
+      // A time limit or baseline regression detected by rank 0 fails every rank, before the sweeps start
+      // collectives
+      if (GetMPIRank() == 0) {
+        try {
+          perf.PrintPerfStatistic(test_name);
+        } catch (const std::exception &e) {
+          error = e.what();
+        }
+      }
+    }
+    error = BcastErrorMPI(error);
+    if (!error.empty()) {
+      throw std::runtime_error(error);
+    }
+
+    ASSERT_TRUE(CheckTestOutputData(task_->GetOutput()));
+
+    if (IsPerfThreadSweep() && IsThreadsTask(task_->GetDynamicTypeOfTask())) {
+      ExecuteThreadSweep(task_getter, reference_getter, test_name, mode);
+    }
+    if (IsPerfSizeSweep()) {
+      ExecuteSizeSweep(task_getter, test_name, mode);
+    }
+  }
+
+ private:
+  ppc::task::TaskPtr<InType, OutType> task_;
+
+  static bool IsThreadsTask(ppc::task::TypeOfTask type_of_task) {
+    return type_of_task == ppc::task::TypeOfTask::kOMP || type_of_task == ppc::task::TypeOfTask::kSTL ||
+           type_of_task == ppc::task::TypeOfTask::kTBB || type_of_task == ppc::task::TypeOfTask::kALL;
+  }
+
+  // Construct the next sweep step task from the input of the previous task, so the input is passed on instead of
+  // copied; Perf reruns a task on the same input, so tasks leave it unchanged and every step sees the original data
+  ppc::performance::PerfResults MeasureNextSweepStep(const PerfTaskGetter<InType, OutType> &task_getter,
+                                                     ppc::performance::PerfResults::TypeOfRunning mode) {
+    return MeasureSweepStep(task_getter(std::move(task_->GetInput())), mode);
+  }
+
+  ppc::performance::PerfResults MeasureSweepStep(ppc::task::TaskPtr<InType, OutType> task,
+                                                 ppc::performance::PerfResults::TypeOfRunning mode,
+                                                 bool check_output = true) {
+    task_ = std::move(task);
     ppc::performance::Perf perf(task_);
     ppc::performance::PerfAttr perf_attr;
     SetPerfAttributes(perf_attr);
-
     if (mode == ppc::performance::PerfResults::TypeOfRunning::kPipeline) {
       perf.PipelineRun(perf_attr);
-    } else if (mode == ppc::performance::PerfResults::TypeOfRunning::kTaskRun) {
-      perf.TaskRun(perf_attr);
     } else {
-      std::stringstream err_msg;
-      err_msg << '\n' << "The type of performance check for the task was not selected.\n";
-      throw std::runtime_error(err_msg.str().c_str());
+      perf.TaskRun(perf_attr);
     }
+    if (check_output) {
+      EXPECT_TRUE(CheckTestOutputData(task_->GetOutput())) << "Wrong output with " << GetNumThreads() << " threads";
+    }
+    return perf.GetPerfResults();
+  }
 
-    if (GetMPIRank() == 0) {
-      perf.PrintPerfStatistic(test_name);
+  // Run the task at 1, 2, 4, ... PPC_NUM_THREADS threads and report speedup and efficiency relative to the
+  // SEQ implementation (or to the single-thread step if the task has none)
+  void ExecuteThreadSweep(const PerfTaskGetter<InType, OutType> &task_getter,
+                          const PerfTaskGetter<InType, OutType> &reference_getter, const std::string &test_name,
+                          ppc::performance::PerfResults::TypeOfRunning mode) {
+    const std::string type_test_name = ppc::performance::GetStringParamName(mode);
+    double reference_time = 0.0;
+    if (reference_getter) {
+      reference_time = MeasureNextSweepStep(reference_getter, mode).time_sec;
+      PrintSweepValue(test_name, type_test_name, "reference", "time", reference_time);
+    }
+    for (int num_threads : ppc::performance::ThreadSweepCounts(GetNumThreads())) {
+      const ScopedNumThreads scoped_threads(num_threads);
+      const double time_sec = MeasureNextSweepStep(task_getter, mode).time_sec;
+      if (reference_time <= 0.0) {
+        reference_time = time_sec;
+      }
+      const double speedup = (time_sec > 0.0) ? reference_time / time_sec : 0.0;
+      const std::string step_name = "threads_" + std::to_string(num_threads);
+      PrintSweepValue(test_name, type_test_name, step_name, "time", time_sec);
+      PrintSweepValue(test_name, type_test_name, step_name, "speedup", speedup);
+      PrintSweepValue(test_name, type_test_name, step_name, "efficiency", speedup / num_threads);
     }
+  }
 
-    OutType output_data = task_->GetOutput();
-    ASSERT_TRUE(CheckTestOutputData(output_data));
+  // Run the task at every size of GetTestInputSizes() and fit time = c * n^k to report the observed
+  // complexity exponent k and the per-element cost
+  void ExecuteSizeSweep(const PerfTaskGetter<InType, OutType> &task_getter, const std::string &test_name,
+                        ppc::performance::PerfResults::TypeOfRunning mode) {
+    const auto sizes = GetTestInputSizes();
+    if (sizes.empty()) {
+      return;
+    }
+    const std::string type_test_name = ppc::performance::GetStringParamName(mode);
+    std::vector<double> sweep_sizes;
+    std::vector<double> sweep_times;
+    for (std::size_t size : sizes) {
+      task_.reset();
+      const double time_sec = MeasureSweepStep(task_getter(GetTestInputDataOfSize(size)), mode, false).time_sec;
+      sweep_sizes.push_back(static_cast<double>(size));
+      sweep_times.push_back(time_sec);
+      const std::string step_name = "size_" + std::to_string(size);
+      PrintSweepValue(test_name, type_test_name, step_name, "time", time_sec);
+      PrintSweepValue(test_name, type_test_name, step_name, "per_element",
+                      (size > 0) ? time_sec / static_cast<double>(size) : 0.0);
+    }
+    const auto fit = ppc::performance::FitComplexity(sweep_sizes, sweep_times);
+    PrintSweepValue(test_name, type_test_name, "complexity", "exponent", fit.exponent);
+    PrintSweepValue(test_name, type_test_name, "complexity", "r_squared", fit.r_squared);
   }
 
- private:
-  ppc::task::TaskPtr<InType, OutType> task_;
+  static void PrintSweepValue(const std::string &test_name, const std::string &type_test_name,
+                              const std::string &step_name, const std::string &stat_name, double value) {
+    if (GetMPIRank() != 0) {
+      return;
+    }
+    std::stringstream value_str;
+    value_str << std::fixed << std::setprecision(10) << value;
+    std::cout << test_name << ":" << type_test_name << ":" << step_name << ":" << stat_name << ":"
+              << value_str.str() << '\n';
+  }
 };
 
+template <typename TaskType>
+using TaskOutType = std::remove_cvref_t<decltype(std::declval<TaskType &>().GetOutput())>;
+
 template <typename TaskType, typename InputType>
-auto MakePerfTaskTuples(const std::string &settings_path) {
+auto MakePerfTaskTuples(const std::string &settings_path,
+                        const PerfTaskGetter<InputType, TaskOutType<TaskType>> &reference_getter = {}) {
   const auto name = std::string(GetNamespace<TaskType>()) + "_" +
                     ppc::task::GetStringTaskType(TaskType::GetStaticTypeOfTask(), settings_path);
 
   return std::make_tuple(std::make_tuple(ppc::task::TaskGetter<TaskType, InputType>, name,
-                                         ppc::performance::PerfResults::TypeOfRunning::kPipeline),
+                                         ppc::performance::PerfResults::TypeOfRunning::kPipeline, reference_getter),
                          std::make_tuple(ppc::task::TaskGetter<TaskType, InputType>, name,
-                                         ppc::performance::PerfResults::TypeOfRunning::kTaskRun));
+                                         ppc::performance::PerfResults::TypeOfRunning::kTaskRun, reference_getter));
+}
+
+/// @brief Returns the getter of the first SEQ task among TaskTypes, or an empty getter if there is none.
+template <typename InputType, typename FirstTaskType, typename... TaskTypes>
+PerfTaskGetter<InputType, TaskOutType<FirstTaskType>> FindSeqTaskGetter() {
+  PerfTaskGetter<InputType, TaskOutType<FirstTaskType>> getter;
+  auto take_if_seq = [&getter]<typename TaskType>() {
+    if (!getter && TaskType::GetStaticTypeOfTask() == ppc::task::TypeOfTask::kSEQ) {
+      getter = ppc::task::TaskGetter<TaskType, InputType>;
+    }
+  };
+  take_if_seq.template operator()<FirstTaskType>();
+  (take_if_seq.template operator()<TaskTypes>(), ...);
+  return getter;
 }
 
 template <typename Tuple, std::size_t... I>
@@ -130,7 +295,8 @@ auto TupleToGTestValues(Tuple &&tup) {
 
 template <typename InputType, typename... TaskTypes>
 auto MakeAllPerfTasks(const std::string &settings_path) {
-  return std::tuple_cat(MakePerfTaskTuples<TaskTypes, InputType>(settings_path)...);
+  const auto reference_getter = FindSeqTaskGetter<InputType, TaskTypes...>();
+  return std::tuple_cat(MakePerfTaskTuples<TaskTypes, InputType>(settings_path, reference_getter)...);
 }
 
 }  // namespace ppc::util
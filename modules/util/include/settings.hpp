@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+namespace ppc::util {
+
+/// @brief Kind of a task directory, the "tasks_type" field of its settings.json.
+enum class TasksType : uint8_t {
+  kProcesses,
+  kThreads,
+  /// The field is missing or has an unexpected value
+  kUnknown,
+};
+
+/// @brief Parsed settings.json of a task directory.
+class TaskSettings {
+ public:
+  /// @param json_text Contents of settings.json.
+  /// @param path File path used in error messages.
+  /// @throws nlohmann::json::exception If the text is not valid JSON.
+  TaskSettings(std::string_view json_text, const std::string &path);
+
+  /// @brief Returns the status string of a technology from the "tasks" object, e.g. "enabled".
+  /// @param technology Technology key such as "seq", "mpi" or "omp".
+  /// @throws std::runtime_error If the technology has no status.
+  /// @throws nlohmann::json::type_error If the status is not a string.
+  [[nodiscard]] const std::string &GetStatus(std::string_view technology) const;
+
+  /// @brief Returns true if the technology has the status "enabled".
+  [[nodiscard]] bool IsEnabled(std::string_view technology) const;
+
+  [[nodiscard]] TasksType GetTasksType() const;
+
+ private:
+  std::string path_;
+  std::map<std::string, nlohmann::json, std::less<>> statuses_;
+  TasksType tasks_type_ = TasksType::kUnknown;
+};
+
+/// @brief Returns the settings of a file, reading and parsing it only on the first call for the path.
+/// @details Thread-safe. Failed reads are not cached, so the next call retries them.
+/// @throws std::runtime_error If the file cannot be opened.
+/// @throws nlohmann::json::exception If the file is not valid JSON.
+const TaskSettings &GetTaskSettings(const std::string &path);
+
+}  // namespace ppc::util
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mpi.h>
+
+namespace ppc::util {
+
+/// @brief Returns true between MPI_Init and MPI_Finalize.
+bool IsMpiActive();
+
+/// @brief Returns the communicator that tasks duplicate: MPI_COMM_WORLD unless a ScopedTaskParentComm is active.
+MPI_Comm GetTaskParentComm();
+
+/// @brief Makes tasks duplicate another communicator for its lifetime, e.g. the group of ranks a runner assigned
+///        to a test. Scopes nest.
+class ScopedTaskParentComm {
+ public:
+  explicit ScopedTaskParentComm(MPI_Comm comm);
+  ~ScopedTaskParentComm();
+
+  ScopedTaskParentComm(const ScopedTaskParentComm &) = delete;
+  ScopedTaskParentComm &operator=(const ScopedTaskParentComm &) = delete;
+  ScopedTaskParentComm(ScopedTaskParentComm &&) = delete;
+  ScopedTaskParentComm &operator=(ScopedTaskParentComm &&) = delete;
+
+ private:
+  MPI_Comm previous_;
+};
+
+/// @brief Private duplicate of the task parent communicator owned by one task.
+/// @details Messages of a task never match receives of another task or of the runner, even when both use the same
+///          tags, and unread messages go away with the duplicate instead of leaking into the next test.
+class TaskComm {
+ public:
+  TaskComm() = default;
+  ~TaskComm();
+
+  TaskComm(const TaskComm &) = delete;
+  TaskComm &operator=(const TaskComm &) = delete;
+  TaskComm(TaskComm &&) = delete;
+  TaskComm &operator=(TaskComm &&) = delete;
+
+  /// @brief Returns the duplicate, creating it from GetTaskParentComm() on the first call.
+  /// @note The first call is collective over the parent communicator.
+  /// @throws std::logic_error If MPI is not initialized.
+  MPI_Comm Get();
+
+  [[nodiscard]] bool IsCreated() const {
+    return comm_ != MPI_COMM_NULL;
+  }
+
+  /// @brief Frees the duplicate; reports a message that was sent to this rank but never received.
+  /// @return False if an unread message was found.
+  bool Free();
+
+ private:
+  MPI_Comm comm_ = MPI_COMM_NULL;
+};
+
+}  // namespace ppc::util
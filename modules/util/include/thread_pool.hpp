@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ppc::util {
+
+/// @brief Work-stealing pool of std::thread workers for the STL backends.
+/// @details Every worker owns a deque: it takes its own jobs from the back and steals the oldest (largest) jobs of
+///          the other workers from the front. The thread that calls ParallelFor() or ParallelReduce() executes jobs
+///          too while it waits, so a pool of N threads has N - 1 workers and nested calls cannot deadlock.
+class ThreadPool {
+ public:
+  /// @param num_threads Number of threads that execute jobs, including the calling one; at least 1.
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+
+  /// @brief Returns the number of threads that execute jobs, including the calling one.
+  [[nodiscard]] int GetNumThreads() const;
+
+  /// @brief Calls body(i) for every i in [begin, end) and returns when all calls have finished.
+  /// @param grain Number of consecutive indices executed as one job; 0 picks about four jobs per thread.
+  /// @throws Rethrows the first exception thrown by body after all started jobs have finished.
+  template <typename Body>
+  void ParallelFor(std::int64_t begin, std::int64_t end, Body &&body, std::int64_t grain = 0) {
+    const std::int64_t chunk = ChunkSize(end - begin, grain);
+    RunChunks(NumChunks(end - begin, chunk), [&](std::int64_t index) {
+      const std::int64_t chunk_begin = begin + (index * chunk);
+      const std::int64_t chunk_end = std::min(end, chunk_begin + chunk);
+      for (std::int64_t i = chunk_begin; i < chunk_end; i++) {
+        body(i);
+      }
+    });
+  }
+
+  /// @brief Reduces [begin, end) in chunks of grain indices.
+  /// @param body Called as body(chunk_begin, chunk_end, identity) and returns the partial result of the chunk.
+  /// @param reduce Combines two partial results.
+  /// @details Partial results are combined in index order, so the result does not depend on the scheduling.
+  /// @throws Rethrows the first exception thrown by body after all started jobs have finished.
+  template <typename T, typename Body, typename Reduce>
+  T ParallelReduce(std::int64_t begin, std::int64_t end, T identity, Body &&body, Reduce &&reduce,
+                   std::int64_t grain = 0) {
+    const std::int64_t chunk = ChunkSize(end - begin, grain);
+    const std::int64_t num_chunks = NumChunks(end - begin, chunk);
+    // Every chunk writes its own element; the wrapper keeps std::vector<bool> from packing them into shared words
+    struct Partial {
+      T value;
+    };
+    std::vector<Partial> partials(static_cast<std::size_t>(num_chunks), Partial{identity});
+    RunChunks(num_chunks, [&](std::int64_t index) {
+      const std::int64_t chunk_begin = begin + (index * chunk);
+      const std::int64_t chunk_end = std::min(end, chunk_begin + chunk);
+      partials[static_cast<std::size_t>(index)].value = body(chunk_begin, chunk_end, identity);
+    });
+    T result = std::move(identity);
+    for (auto &partial : partials) {
+      result = reduce(std::move(result), std::move(partial.value));
+    }
+    return result;
+  }
+
+ private:
+  using Job = std::function<void()>;
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  struct JobGroup;
+
+  [[nodiscard]] std::int64_t ChunkSize(std::int64_t size, std::int64_t grain) const;
+  static std::int64_t NumChunks(std::int64_t size, std::int64_t chunk);
+  void RunChunks(std::int64_t num_chunks, const std::function<void(std::int64_t)> &chunk_body);
+  void SplitChunks(JobGroup &group, std::int64_t first, std::int64_t last,
+                   const std::function<void(std::int64_t)> &chunk_body);
+  void Spawn(Job job);
+  bool TryRunJob();
+  void WorkerLoop(std::size_t index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> next_queue_{0};
+  std::atomic<std::int64_t> queued_jobs_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_up_;
+  bool stop_ = false;
+};
+
+/// @brief Returns the process-wide pool with GetNumThreads() threads.
+/// @details The pool is created on first use and recreated when GetNumThreads() changes (e.g. in a thread sweep);
+///          calls from inside a pool job always return the running pool.
+ThreadPool &GetThreadPool();
+
+/// @brief Joins the workers of the process-wide pool; the next GetThreadPool() starts new ones.
+void ReleaseThreadPool();
+
+}  // namespace ppc::util
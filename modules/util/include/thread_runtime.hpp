@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ppc::util {
+
+/// @brief Lifetime policy of the OpenMP, TBB and STL worker threads of the process.
+enum class ThreadRuntimeMode : uint8_t {
+  /// Workers are started once and stay alive for all tasks until the process exits
+  kPersistent,
+  /// Workers are released after every task to give their stacks and caches back (memory-pressure mode)
+  kReleaseAfterTask,
+};
+
+/// @brief Returns the current lifetime policy.
+/// @details Initially kReleaseAfterTask when PPC_RELEASE_THREADS is set to a non-zero value, otherwise kPersistent.
+ThreadRuntimeMode GetThreadRuntimeMode();
+
+/// @brief Changes the lifetime policy for the whole process.
+void SetThreadRuntimeMode(ThreadRuntimeMode mode);
+
+/// @brief Starts the OpenMP, TBB and STL pool workers for GetNumThreads() threads, so the first task does not pay for
+///        thread creation.
+void WarmUpThreadRuntime();
+
+/// @brief Stops the worker threads of every runtime; the next parallel region starts them again.
+/// @details Must be called from the main thread outside of any parallel region.
+void ReleaseThreadRuntime();
+
+/// @brief Called when a task is destroyed; releases the workers only in kReleaseAfterTask mode.
+void OnTaskFinished();
+
+/// @brief Returns how many times the workers were released by this process.
+std::size_t GetThreadRuntimeReleaseCount();
+
+}  // namespace ppc::util
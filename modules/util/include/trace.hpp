@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ppc::util {
+
+/// @brief Returns true if timeline events are recorded.
+/// @details Initially enabled when PPC_TRACE_FILE is set; can be changed with EnableTracing().
+bool IsTracingEnabled();
+
+/// @brief Turns event recording on or off for the whole process.
+void EnableTracing(bool enabled);
+
+/// @brief Sets the process id (the MPI rank) that tags every event of this process.
+void SetTraceProcess(int process_id);
+
+/// @brief Returns the time since the trace origin in microseconds.
+double TraceNowUs();
+
+/// @brief Moves the trace origin to the current time.
+/// @details Calling it on every rank right after a barrier aligns the timelines of the ranks.
+void ResetTraceClock();
+
+/// @brief Records a complete event of the calling thread.
+/// @param name Event name shown in the timeline.
+/// @param category Event category, e.g. "task" or "user".
+/// @param begin_us Start time returned by TraceNowUs().
+/// @param end_us End time returned by TraceNowUs().
+void RecordTraceEvent(std::string_view name, std::string_view category, double begin_us, double end_us);
+
+/// @brief Removes the recorded events of this process and returns them serialized.
+/// @return Comma-separated Chrome trace event objects, including the process name metadata; empty if there
+///         are no events.
+std::string TakeTraceEvents();
+
+/// @brief Writes a Chrome trace JSON file that can be opened in Perfetto or chrome://tracing.
+/// @param path Output file path.
+/// @param event_chunks Results of TakeTraceEvents() of every process.
+/// @throws std::runtime_error If the file cannot be written.
+void WriteTraceFile(const std::string &path, const std::vector<std::string> &event_chunks);
+
+/// @brief Records the lifetime of the object as an event, e.g. to mark a phase inside RunImpl().
+/// @details Does nothing when tracing is disabled.
+class TraceScope {
+ public:
+  explicit TraceScope(std::string name, std::string category = "user");
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+  TraceScope(TraceScope &&) = delete;
+  TraceScope &operator=(TraceScope &&) = delete;
+  ~TraceScope();
+
+ private:
+  std::string name_;
+  std::string category_;
+  double begin_us_ = -1.0;
+};
+
+}  // namespace ppc::util
@@ -4,6 +4,7 @@
 #include <array>
 #include <atomic>
 #include <cctype>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <filesystem>
@@ -68,6 +69,7 @@ enum class GTestParamIndex : uint8_t {
   kTaskGetter,
   kNameTest,
   kTestParams,
+  kReferenceTaskGetter,
 };
 
 std::string GetAbsoluteTaskPath(const std::string &id_path, const std::string &relative_path);
@@ -75,6 +77,43 @@ int GetNumThreads();
 int GetNumProc();
 double GetTaskMaxTime();
 double GetPerfMaxTime();
+int GetPerfWarmupRuns();
+bool IsPerfAdaptive();
+std::string GetPerfOutputDir();
+std::string GetPerfOutputFormat();
+std::string GetHostName();
+std::string GetGitRevision();
+std::string GetPerfBaselineFile();
+double GetPerfRegressionThreshold();
+bool IsPerfBaselineUpdate();
+bool IsPerfThreadSweep();
+bool IsPerfSizeSweep();
+bool IsPerfColdCache();
+bool IsPerfHardwareCounters();
+bool IsReleaseThreads();
+std::string GetMpiThreadLevelName();
+std::string GetTraceFile();
+std::size_t GetCommBenchMaxBytes();
+int GetRunnerGroups();
+
+/// @brief Applies a thread count to GetNumThreads(), the TBB scheduler and OpenMP for its lifetime.
+/// @details Scopes nest: leaving a scope restores the configuration of the enclosing one, so a perf sweep can
+///          change the thread count of threads-type tasks without relaunching the process.
+class ScopedNumThreads {
+ public:
+  /// @param num_threads Thread count to apply; 0 keeps PPC_NUM_THREADS and only enforces it as the TBB limit.
+  explicit ScopedNumThreads(int num_threads);
+  ~ScopedNumThreads();
+
+  ScopedNumThreads(const ScopedNumThreads &) = delete;
+  ScopedNumThreads &operator=(const ScopedNumThreads &) = delete;
+  ScopedNumThreads(ScopedNumThreads &&) = delete;
+  ScopedNumThreads &operator=(ScopedNumThreads &&) = delete;
+
+ private:
+  int previous_num_threads_ = 0;
+  bool previous_active_ = false;
+};
 
 template <typename T>
 std::string GetNamespace() {
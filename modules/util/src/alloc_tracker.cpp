@@ -0,0 +1,232 @@
+#include "util/include/alloc_tracker.hpp"
+
+#include <cstdint>
+
+#ifdef PPC_ALLOC_TRACKING
+#  include <atomic>
+#  include <cstddef>
+#  include <cstdlib>
+#  include <new>
+#  ifdef __APPLE__
+#    include <malloc/malloc.h>
+#  else
+#    include <malloc.h>
+#  endif
+#endif
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#endif
+
+#ifdef PPC_ALLOC_TRACKING
+
+namespace {
+
+struct AllocationState {
+  std::atomic<uint64_t> allocations{0};
+  std::atomic<uint64_t> deallocations{0};
+  std::atomic<uint64_t> allocated_bytes{0};
+  std::atomic<uint64_t> live_bytes{0};
+  std::atomic<uint64_t> peak_live_bytes{0};
+};
+
+// Constant-initialized, so it is usable by allocations made before dynamic initialization
+constinit AllocationState g_state;
+
+std::size_t UsableSize(void *ptr, std::size_t alignment) {
+#if defined(_WIN32)
+  return (alignment != 0) ? _aligned_msize(ptr, alignment, 0) : _msize(ptr);
+#elif defined(__APPLE__)
+  static_cast<void>(alignment);
+  return malloc_size(ptr);
+#else
+  static_cast<void>(alignment);
+  return malloc_usable_size(ptr);
+#endif
+}
+
+void RecordAllocation(std::size_t bytes) {
+  g_state.allocations.fetch_add(1, std::memory_order_relaxed);
+  g_state.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  const uint64_t live = g_state.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  uint64_t peak = g_state.peak_live_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !g_state.peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void *RawAllocate(std::size_t size, std::size_t alignment) {
+  if (alignment == 0) {
+    return std::malloc(size);
+  }
+#ifdef _WIN32
+  return _aligned_malloc(size, alignment);
+#else
+  void *ptr = nullptr;
+  return (posix_memalign(&ptr, alignment, size) == 0) ? ptr : nullptr;
+#endif
+}
+
+void RawFree(void *ptr, std::size_t alignment) {
+#ifdef _WIN32
+  if (alignment != 0) {
+    _aligned_free(ptr);
+    return;
+  }
+#else
+  static_cast<void>(alignment);
+#endif
+  std::free(ptr);
+}
+
+// Allocation loop required of operator new: retry through the new-handler until it gives up
+void *TrackedAllocate(std::size_t size, std::size_t alignment, bool nothrow) {
+  if (size == 0) {
+    size = 1;
+  }
+  void *ptr = RawAllocate(size, alignment);
+  while (ptr == nullptr) {
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      if (nothrow) {
+        return nullptr;
+      }
+      throw std::bad_alloc();
+    }
+    handler();
+    ptr = RawAllocate(size, alignment);
+  }
+  RecordAllocation(UsableSize(ptr, alignment));
+  return ptr;
+}
+
+void TrackedFree(void *ptr, std::size_t alignment) {
+  if (ptr == nullptr) {
+    return;
+  }
+  g_state.deallocations.fetch_add(1, std::memory_order_relaxed);
+  g_state.live_bytes.fetch_sub(UsableSize(ptr, alignment), std::memory_order_relaxed);
+  RawFree(ptr, alignment);
+}
+
+}  // namespace
+
+void *operator new(std::size_t size) {
+  return TrackedAllocate(size, 0, false);
+}
+
+void *operator new[](std::size_t size) {
+  return TrackedAllocate(size, 0, false);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t & /*tag*/) noexcept {
+  return TrackedAllocate(size, 0, true);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t & /*tag*/) noexcept {
+  return TrackedAllocate(size, 0, true);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return TrackedAllocate(size, static_cast<std::size_t>(alignment), false);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return TrackedAllocate(size, static_cast<std::size_t>(alignment), false);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t & /*tag*/) noexcept {
+  return TrackedAllocate(size, static_cast<std::size_t>(alignment), true);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t & /*tag*/) noexcept {
+  return TrackedAllocate(size, static_cast<std::size_t>(alignment), true);
+}
+
+void operator delete(void *ptr) noexcept {
+  TrackedFree(ptr, 0);
+}
+
+void operator delete[](void *ptr) noexcept {
+  TrackedFree(ptr, 0);
+}
+
+void operator delete(void *ptr, std::size_t /*size*/) noexcept {
+  TrackedFree(ptr, 0);
+}
+
+void operator delete[](void *ptr, std::size_t /*size*/) noexcept {
+  TrackedFree(ptr, 0);
+}
+
+void operator delete(void *ptr, const std::nothrow_t & /*tag*/) noexcept {
+  TrackedFree(ptr, 0);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t & /*tag*/) noexcept {
+  TrackedFree(ptr, 0);
+}
+
+void operator delete(void *ptr, std::align_val_t alignment) noexcept {
+  TrackedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment) noexcept {
+  TrackedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr, std::size_t /*size*/, std::align_val_t alignment) noexcept {
+  TrackedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *ptr, std::size_t /*size*/, std::align_val_t alignment) noexcept {
+  TrackedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *ptr, std::align_val_t alignment, const std::nothrow_t & /*tag*/) noexcept {
+  TrackedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void *ptr, std::align_val_t alignment, const std::nothrow_t & /*tag*/) noexcept {
+  TrackedFree(ptr, static_cast<std::size_t>(alignment));
+}
+
+ppc::util::AllocationCounters ppc::util::GetAllocationCounters() {
+  AllocationCounters counters;
+  counters.allocations = g_state.allocations.load(std::memory_order_relaxed);
+  counters.deallocations = g_state.deallocations.load(std::memory_order_relaxed);
+  counters.allocated_bytes = g_state.allocated_bytes.load(std::memory_order_relaxed);
+  counters.live_bytes = g_state.live_bytes.load(std::memory_order_relaxed);
+  counters.peak_live_bytes = g_state.peak_live_bytes.load(std::memory_order_relaxed);
+  return counters;
+}
+
+void ppc::util::ResetAllocationPeak() {
+  g_state.peak_live_bytes.store(g_state.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+#else
+
+ppc::util::AllocationCounters ppc::util::GetAllocationCounters() {
+  return {};
+}
+
+void ppc::util::ResetAllocationPeak() {}
+
+#endif
+
+uint64_t ppc::util::GetPeakRssBytes() {
+#ifdef _WIN32
+  return 0;
+#else
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#  ifdef __APPLE__
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#  else
+  // Linux reports kilobytes
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#  endif
+#endif
+}
@@ -1,6 +1,11 @@
 #include <mpi.h>
 
+#include <cstddef>
+#include <string>
+#include <vector>
+
 #include "util/include/perf_test_util.hpp"
+#include "util/include/task_comm.hpp"
 
 double ppc::util::GetTimeMPI() {
   return MPI_Wtime();
@@ -8,6 +13,28 @@ double ppc::util::GetTimeMPI() {
 
 int ppc::util::GetMPIRank() {
   int rank = -1;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(ppc::util::GetTaskParentComm(), &rank);
   return rank;
 }
+
+void ppc::util::BarrierMPI() {
+  MPI_Barrier(ppc::util::GetTaskParentComm());
+}
+
+std::vector<double> ppc::util::AllGatherMPI(const std::vector<double> &values) {
+  int size = 1;
+  MPI_Comm_size(ppc::util::GetTaskParentComm(), &size);
+  const int count = static_cast<int>(values.size());
+  std::vector<double> gathered(values.size() * static_cast<std::size_t>(size));
+  MPI_Allgather(values.data(), count, MPI_DOUBLE, gathered.data(), count, MPI_DOUBLE, ppc::util::GetTaskParentComm());
+  return gathered;
+}
+
+std::string ppc::util::BcastErrorMPI(const std::string &error) {
+  int length = static_cast<int>(error.size());
+  MPI_Bcast(&length, 1, MPI_INT, 0, ppc::util::GetTaskParentComm());
+  std::string result = error;
+  result.resize(static_cast<std::size_t>(length));
+  MPI_Bcast(result.data(), length, MPI_CHAR, 0, ppc::util::GetTaskParentComm());
+  return result;
+}
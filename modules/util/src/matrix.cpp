@@ -0,0 +1,36 @@
+#include "util/include/matrix.hpp"
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+int ToMpiInt(std::size_t value, const char *what) {
+  if (value > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    throw std::overflow_error(std::string(what) + " of " + std::to_string(value) + " exceeds the MPI count range");
+  }
+  return static_cast<int>(value);
+}
+
+}  // namespace
+
+ppc::util::MatrixRowType::MatrixRowType(std::size_t row_bytes, std::size_t stride_bytes) {
+  MPI_Datatype row = MPI_DATATYPE_NULL;
+  MPI_Type_contiguous(ToMpiInt(row_bytes, "Matrix row size"), MPI_BYTE, &row);
+  // The extent makes a count of N rows skip the padding or the columns outside of a tile
+  MPI_Type_create_resized(row, 0, static_cast<MPI_Aint>(stride_bytes), &type_);
+  MPI_Type_commit(&type_);
+  MPI_Type_free(&row);
+}
+
+ppc::util::MatrixRowType::~MatrixRowType() {
+  MPI_Type_free(&type_);
+}
+
+int ppc::util::ToMpiRowCount(std::size_t rows) {
+  return ToMpiInt(rows, "Matrix row count");
+}
@@ -0,0 +1,104 @@
+#include "util/include/mpi_collectives.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int ToMpiInt(std::size_t value) {
+  if (value > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+    throw std::overflow_error("Partition value " + std::to_string(value) + " exceeds the MPI count range");
+  }
+  return static_cast<int>(value);
+}
+
+}  // namespace
+
+ppc::util::mpi::BlockPartition::BlockPartition(std::size_t total, int parts, std::size_t halo, std::size_t unit_size)
+    : total_(total * unit_size) {
+  if (parts <= 0) {
+    throw std::invalid_argument("A partition needs at least one part");
+  }
+  if (unit_size == 0) {
+    throw std::invalid_argument("Partition units must have at least one element");
+  }
+  const auto num_parts = static_cast<std::size_t>(parts);
+  const std::size_t base = total / num_parts;
+  const std::size_t remainder = total % num_parts;
+  counts_.resize(num_parts);
+  displs_.resize(num_parts);
+  halo_counts_.resize(num_parts);
+  halo_displs_.resize(num_parts);
+  std::size_t begin = 0;
+  for (std::size_t part = 0; part < num_parts; part++) {
+    const std::size_t count = base + (part < remainder ? 1 : 0);
+    const std::size_t end = begin + count;
+    // Empty blocks get no halo, so ranks without work receive nothing
+    const std::size_t halo_begin = count == 0 ? begin : begin - std::min(begin, halo);
+    const std::size_t halo_end = count == 0 ? end : std::min(total, end + halo);
+    counts_[part] = ToMpiInt(count * unit_size);
+    displs_[part] = ToMpiInt(begin * unit_size);
+    halo_counts_[part] = ToMpiInt((halo_end - halo_begin) * unit_size);
+    halo_displs_[part] = ToMpiInt(halo_begin * unit_size);
+    begin = end;
+  }
+  // Blocks are consecutive, so the owners of a halo are the nearest parts on both sides
+  for (int part = 0; part < parts; part++) {
+    for (int owner = part - 1; owner >= 0 && HaloShare(part, owner).second > 0; owner--) {
+      halo_reach_ = std::max(halo_reach_, part - owner);
+    }
+    for (int owner = part + 1; owner < parts && HaloShare(part, owner).second > 0; owner++) {
+      halo_reach_ = std::max(halo_reach_, owner - part);
+    }
+  }
+}
+
+std::size_t ppc::util::mpi::BlockPartition::Count(int part) const {
+  return static_cast<std::size_t>(counts_.at(static_cast<std::size_t>(part)));
+}
+
+std::size_t ppc::util::mpi::BlockPartition::Offset(int part) const {
+  return static_cast<std::size_t>(displs_.at(static_cast<std::size_t>(part)));
+}
+
+std::size_t ppc::util::mpi::BlockPartition::HaloCount(int part) const {
+  return static_cast<std::size_t>(halo_counts_.at(static_cast<std::size_t>(part)));
+}
+
+std::size_t ppc::util::mpi::BlockPartition::HaloOffset(int part) const {
+  return static_cast<std::size_t>(halo_displs_.at(static_cast<std::size_t>(part)));
+}
+
+std::pair<std::size_t, std::size_t> ppc::util::mpi::BlockPartition::HaloShare(int part, int owner) const {
+  if (part == owner) {
+    return {Offset(part), 0};
+  }
+  const std::size_t begin = std::max(HaloOffset(part), Offset(owner));
+  const std::size_t end = std::min(HaloOffset(part) + HaloCount(part), Offset(owner) + Count(owner));
+  return {begin, end > begin ? end - begin : 0};
+}
+
+int ppc::util::mpi::BlockPartition::HaloReach() const {
+  return halo_reach_;
+}
+
+const std::vector<int> &ppc::util::mpi::BlockPartition::Counts() const {
+  return counts_;
+}
+
+const std::vector<int> &ppc::util::mpi::BlockPartition::Displs() const {
+  return displs_;
+}
+
+const std::vector<int> &ppc::util::mpi::BlockPartition::HaloCounts() const {
+  return halo_counts_;
+}
+
+const std::vector<int> &ppc::util::mpi::BlockPartition::HaloDispls() const {
+  return halo_displs_;
+}
@@ -0,0 +1,464 @@
+#include "util/include/mpi_profiler.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#ifdef PPC_MPI_PROFILING
+#  include <mpi.h>
+
+#  include <cstddef>
+#  include <cstdint>
+#  include <map>
+#  include <memory>
+#  include <mutex>
+#  include <numeric>
+#  include <optional>
+#  include <string_view>
+#  include <tuple>
+#endif
+
+namespace {
+
+std::atomic<const char *> g_stage{nullptr};
+
+}  // namespace
+
+void ppc::util::SetMpiProfileStage(const char *stage) {
+  g_stage.store(stage, std::memory_order_relaxed);
+}
+
+#ifdef PPC_MPI_PROFILING
+
+namespace {
+
+struct CallInfo {
+  int peer = -1;
+  bool sends = false;
+  uint64_t bytes = 0;
+};
+
+struct CallTotals {
+  uint64_t calls = 0;
+  uint64_t bytes = 0;
+  double time_sec = 0.0;
+};
+
+// Stage and function names are string literals, so views of them stay valid
+using ProfileKey = std::tuple<std::string_view, std::string_view, int, bool>;
+
+// Receive posted by MPI_Irecv whose size is only known once MPI_Wait or MPI_Waitall completes it
+struct PendingRecv {
+  const char *stage;
+  MPI_Datatype datatype;
+  MPI_Comm comm;
+};
+
+struct ProfileState {
+  std::mutex mutex;
+  std::map<ProfileKey, CallTotals> totals;
+  std::map<MPI_Request, PendingRecv> pending_recvs;
+};
+
+ProfileState &GetProfileState() {
+  static ProfileState state;
+  return state;
+}
+
+uint64_t PayloadBytes(int count, MPI_Datatype datatype) {
+  int type_size = 0;
+  PMPI_Type_size(datatype, &type_size);
+  return static_cast<uint64_t>(count) * static_cast<uint64_t>(type_size);
+}
+
+// World ranks of all ranks of a communicator; empty if they are the same
+using RankTranslation = std::vector<int>;
+
+int DeleteRankTranslation(MPI_Comm /*comm*/, int /*keyval*/, void *attribute, void * /*extra_state*/) {
+  delete static_cast<RankTranslation *>(attribute);
+  return MPI_SUCCESS;
+}
+
+// The translation is cached as an attribute of the communicator and freed together with it
+int RankTranslationKeyval() {
+  static const int kKeyval = [] {
+    int keyval = MPI_KEYVAL_INVALID;
+    PMPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, DeleteRankTranslation, &keyval, nullptr);
+    return keyval;
+  }();
+  return kKeyval;
+}
+
+const RankTranslation &GetRankTranslation(MPI_Comm comm) {
+  void *attribute = nullptr;
+  int found = 0;
+  PMPI_Comm_get_attr(comm, RankTranslationKeyval(), &attribute, &found);
+  if (found != 0) {
+    return *static_cast<RankTranslation *>(attribute);
+  }
+  auto translation = std::make_unique<RankTranslation>();
+  int comparison = MPI_UNEQUAL;
+  PMPI_Comm_compare(comm, MPI_COMM_WORLD, &comparison);
+  if (comparison != MPI_IDENT && comparison != MPI_CONGRUENT) {
+    MPI_Group group = MPI_GROUP_NULL;
+    MPI_Group world_group = MPI_GROUP_NULL;
+    PMPI_Comm_group(comm, &group);
+    PMPI_Comm_group(MPI_COMM_WORLD, &world_group);
+    int size = 0;
+    PMPI_Group_size(group, &size);
+    std::vector<int> ranks(static_cast<std::size_t>(size));
+    std::iota(ranks.begin(), ranks.end(), 0);
+    translation->resize(ranks.size());
+    PMPI_Group_translate_ranks(group, size, ranks.data(), world_group, translation->data());
+    PMPI_Group_free(&group);
+    PMPI_Group_free(&world_group);
+  }
+  PMPI_Comm_set_attr(comm, RankTranslationKeyval(), translation.get());
+  return *translation.release();
+}
+
+// Peers are reported as MPI_COMM_WORLD ranks so that the matrix stays valid for derived communicators
+int WorldRank(MPI_Comm comm, int rank) {
+  if (rank < 0) {
+    return -1;
+  }
+  const auto &translation = GetRankTranslation(comm);
+  if (translation.empty()) {
+    return rank;
+  }
+  if (static_cast<std::size_t>(rank) >= translation.size()) {
+    return -1;
+  }
+  const int world_rank = translation[static_cast<std::size_t>(rank)];
+  return (world_rank == MPI_UNDEFINED) ? -1 : world_rank;
+}
+
+// Times an intercepted call and attributes it to the current task stage, if any
+class ProfiledCall {
+ public:
+  explicit ProfiledCall(const char *function)
+      : function_(function), stage_(g_stage.load(std::memory_order_relaxed)) {
+    if (stage_ != nullptr) {
+      begin_ = PMPI_Wtime();
+    }
+  }
+  ProfiledCall(const ProfiledCall &) = delete;
+  ProfiledCall &operator=(const ProfiledCall &) = delete;
+  ProfiledCall(ProfiledCall &&) = delete;
+  ProfiledCall &operator=(ProfiledCall &&) = delete;
+
+  // The description is only computed for calls that are recorded
+  template <typename Describe>
+  void Set(Describe describe) {
+    if (stage_ != nullptr) {
+      info_ = describe();
+    }
+  }
+
+  [[nodiscard]] const char *Stage() const {
+    return stage_;
+  }
+
+  // Second direction of a combined call such as MPI_Sendrecv; it adds bytes without counting the call again
+  template <typename Describe>
+  void SetSecond(Describe describe) {
+    if (stage_ != nullptr) {
+      second_info_ = describe();
+    }
+  }
+
+  ~ProfiledCall() {
+    if (stage_ == nullptr) {
+      return;
+    }
+    const double elapsed = PMPI_Wtime() - begin_;
+    auto &state = GetProfileState();
+    const std::scoped_lock lock(state.mutex);
+    auto &totals = state.totals[ProfileKey{stage_, function_, info_.peer, info_.sends}];
+    totals.calls++;
+    totals.bytes += info_.bytes;
+    totals.time_sec += elapsed;
+    if (second_info_.has_value()) {
+      state.totals[ProfileKey{stage_, function_, second_info_->peer, second_info_->sends}].bytes +=
+          second_info_->bytes;
+    }
+  }
+
+ private:
+  const char *function_;
+  const char *stage_;
+  double begin_ = 0.0;
+  CallInfo info_;
+  std::optional<CallInfo> second_info_;
+};
+
+void TrackRecv(const char *stage, MPI_Request request, MPI_Datatype datatype, MPI_Comm comm) {
+  auto &state = GetProfileState();
+  const std::scoped_lock lock(state.mutex);
+  state.pending_recvs.insert_or_assign(request, PendingRecv{.stage = stage, .datatype = datatype, .comm = comm});
+}
+
+// Handles are reused after completion; a request that is not a tracked receive must not match a stale entry
+void ForgetRequest(MPI_Request request) {
+  auto &state = GetProfileState();
+  const std::scoped_lock lock(state.mutex);
+  state.pending_recvs.erase(request);
+}
+
+// Adds the bytes of a completed MPI_Irecv to the stage it was posted in, attributed to the actual sender.
+// Receives completed by functions that are not intercepted, e.g. MPI_Test, are not counted
+void CountCompletedRecv(MPI_Request request, const MPI_Status &status) {
+  if (request == MPI_REQUEST_NULL) {
+    return;
+  }
+  auto &state = GetProfileState();
+  const std::scoped_lock lock(state.mutex);
+  const auto it = state.pending_recvs.find(request);
+  if (it == state.pending_recvs.end()) {
+    return;
+  }
+  const PendingRecv recv = it->second;
+  state.pending_recvs.erase(it);
+  int cancelled = 0;
+  PMPI_Test_cancelled(&status, &cancelled);
+  if (cancelled != 0) {
+    return;
+  }
+  int received = 0;
+  PMPI_Get_count(&status, recv.datatype, &received);
+  state.totals[ProfileKey{recv.stage, "MPI_Irecv", WorldRank(recv.comm, status.MPI_SOURCE), false}].bytes +=
+      PayloadBytes(received, recv.datatype);
+}
+
+int CommRank(MPI_Comm comm) {
+  int rank = -1;
+  PMPI_Comm_rank(comm, &rank);
+  return rank;
+}
+
+}  // namespace
+
+std::vector<ppc::util::MpiProfileEntry> ppc::util::TakeMpiProfile() {
+  auto &state = GetProfileState();
+  std::map<ProfileKey, CallTotals> totals;
+  {
+    const std::scoped_lock lock(state.mutex);
+    totals.swap(state.totals);
+  }
+  std::vector<MpiProfileEntry> entries;
+  entries.reserve(totals.size());
+  for (const auto &[key, value] : totals) {
+    const auto &[stage, function, peer, sends] = key;
+    entries.push_back(MpiProfileEntry{.stage = std::string(stage),
+                                      .function = std::string(function),
+                                      .peer = peer,
+                                      .sends = sends,
+                                      .calls = value.calls,
+                                      .bytes = value.bytes,
+                                      .time_sec = value.time_sec});
+  }
+  return entries;
+}
+
+int MPI_Send(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm) {
+  ProfiledCall call("MPI_Send");
+  call.Set([&] { return CallInfo{WorldRank(comm, dest), true, PayloadBytes(count, datatype)}; });
+  return PMPI_Send(buf, count, datatype, dest, tag, comm);
+}
+
+int MPI_Ssend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm) {
+  ProfiledCall call("MPI_Ssend");
+  call.Set([&] { return CallInfo{WorldRank(comm, dest), true, PayloadBytes(count, datatype)}; });
+  return PMPI_Ssend(buf, count, datatype, dest, tag, comm);
+}
+
+int MPI_Isend(const void *buf, int count, MPI_Datatype datatype, int dest, int tag, MPI_Comm comm,
+              MPI_Request *request) {
+  ProfiledCall call("MPI_Isend");
+  call.Set([&] { return CallInfo{WorldRank(comm, dest), true, PayloadBytes(count, datatype)}; });
+  const int result = PMPI_Isend(buf, count, datatype, dest, tag, comm, request);
+  if (result == MPI_SUCCESS) {
+    ForgetRequest(*request);
+  }
+  return result;
+}
+
+int MPI_Recv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm, MPI_Status *status) {
+  MPI_Status local_status;
+  MPI_Status *used_status = (status == MPI_STATUS_IGNORE) ? &local_status : status;
+  ProfiledCall call("MPI_Recv");
+  const int result = PMPI_Recv(buf, count, datatype, source, tag, comm, used_status);
+  // The status identifies the sender of MPI_ANY_SOURCE receives and the actual message size
+  call.Set([&] {
+    int received = 0;
+    PMPI_Get_count(used_status, datatype, &received);
+    return CallInfo{WorldRank(comm, used_status->MPI_SOURCE), false, PayloadBytes(received, datatype)};
+  });
+  return result;
+}
+
+int MPI_Irecv(void *buf, int count, MPI_Datatype datatype, int source, int tag, MPI_Comm comm,
+              MPI_Request *request) {
+  ProfiledCall call("MPI_Irecv");
+  // count only bounds the message; the received bytes are added when MPI_Wait or MPI_Waitall completes it
+  call.Set([&] { return CallInfo{WorldRank(comm, source), false, 0}; });
+  const int result = PMPI_Irecv(buf, count, datatype, source, tag, comm, request);
+  if (result == MPI_SUCCESS) {
+    if (call.Stage() != nullptr) {
+      TrackRecv(call.Stage(), *request, datatype, comm);
+    } else {
+      ForgetRequest(*request);
+    }
+  }
+  return result;
+}
+
+int MPI_Sendrecv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, int dest, int sendtag, void *recvbuf,
+                 int recvcount, MPI_Datatype recvtype, int source, int recvtag, MPI_Comm comm, MPI_Status *status) {
+  MPI_Status local_status;
+  MPI_Status *used_status = (status == MPI_STATUS_IGNORE) ? &local_status : status;
+  ProfiledCall call("MPI_Sendrecv");
+  const int result = PMPI_Sendrecv(sendbuf, sendcount, sendtype, dest, sendtag, recvbuf, recvcount, recvtype, source,
+                                   recvtag, comm, used_status);
+  call.Set([&] { return CallInfo{WorldRank(comm, dest), true, PayloadBytes(sendcount, sendtype)}; });
+  call.SetSecond([&] {
+    int received = 0;
+    PMPI_Get_count(used_status, recvtype, &received);
+    return CallInfo{WorldRank(comm, used_status->MPI_SOURCE), false, PayloadBytes(received, recvtype)};
+  });
+  return result;
+}
+
+int MPI_Wait(MPI_Request *request, MPI_Status *status) {
+  MPI_Status local_status;
+  MPI_Status *used_status = (status == MPI_STATUS_IGNORE) ? &local_status : status;
+  // Completion resets the handle, so the posted one identifies the receive
+  const MPI_Request posted = *request;
+  ProfiledCall call("MPI_Wait");
+  const int result = PMPI_Wait(request, used_status);
+  if (result == MPI_SUCCESS) {
+    CountCompletedRecv(posted, *used_status);
+  }
+  return result;
+}
+
+int MPI_Waitall(int count, MPI_Request array_of_requests[], MPI_Status array_of_statuses[]) {
+  const std::vector<MPI_Request> posted(array_of_requests, array_of_requests + count);
+  std::vector<MPI_Status> local_statuses;
+  MPI_Status *used_statuses = array_of_statuses;
+  if (array_of_statuses == MPI_STATUSES_IGNORE) {
+    local_statuses.resize(posted.size());
+    used_statuses = local_statuses.data();
+  }
+  ProfiledCall call("MPI_Waitall");
+  const int result = PMPI_Waitall(count, array_of_requests, used_statuses);
+  if (result == MPI_SUCCESS) {
+    for (std::size_t i = 0; i < posted.size(); i++) {
+      CountCompletedRecv(posted[i], used_statuses[i]);
+    }
+  }
+  return result;
+}
+
+int MPI_Barrier(MPI_Comm comm) {
+  ProfiledCall call("MPI_Barrier");
+  return PMPI_Barrier(comm);
+}
+
+int MPI_Bcast(void *buffer, int count, MPI_Datatype datatype, int root, MPI_Comm comm) {
+  ProfiledCall call("MPI_Bcast");
+  call.Set([&] { return CallInfo{WorldRank(comm, root), false, PayloadBytes(count, datatype)}; });
+  return PMPI_Bcast(buffer, count, datatype, root, comm);
+}
+
+int MPI_Scatter(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  ProfiledCall call("MPI_Scatter");
+  // With MPI_IN_PLACE the root keeps its block and ignores recvcount
+  call.Set([&] {
+    const bool in_place = recvbuf == MPI_IN_PLACE && CommRank(comm) == root;
+    return CallInfo{WorldRank(comm, root), false, in_place ? 0 : PayloadBytes(recvcount, recvtype)};
+  });
+  return PMPI_Scatter(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+}
+
+int MPI_Scatterv(const void *sendbuf, const int sendcounts[], const int displs[], MPI_Datatype sendtype,
+                 void *recvbuf, int recvcount, MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  ProfiledCall call("MPI_Scatterv");
+  call.Set([&] {
+    const bool in_place = recvbuf == MPI_IN_PLACE && CommRank(comm) == root;
+    return CallInfo{WorldRank(comm, root), false, in_place ? 0 : PayloadBytes(recvcount, recvtype)};
+  });
+  return PMPI_Scatterv(sendbuf, sendcounts, displs, sendtype, recvbuf, recvcount, recvtype, root, comm);
+}
+
+int MPI_Gather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+               MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  ProfiledCall call("MPI_Gather");
+  // With MPI_IN_PLACE the root's block is already in place and sendcount and sendtype are ignored
+  call.Set([&] {
+    const bool in_place = sendbuf == MPI_IN_PLACE && CommRank(comm) == root;
+    return CallInfo{WorldRank(comm, root), false, in_place ? 0 : PayloadBytes(sendcount, sendtype)};
+  });
+  return PMPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm);
+}
+
+int MPI_Gatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                const int displs[], MPI_Datatype recvtype, int root, MPI_Comm comm) {
+  ProfiledCall call("MPI_Gatherv");
+  call.Set([&] {
+    const bool in_place = sendbuf == MPI_IN_PLACE && CommRank(comm) == root;
+    return CallInfo{WorldRank(comm, root), false, in_place ? 0 : PayloadBytes(sendcount, sendtype)};
+  });
+  return PMPI_Gatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, root, comm);
+}
+
+int MPI_Allgather(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                  MPI_Datatype recvtype, MPI_Comm comm) {
+  ProfiledCall call("MPI_Allgather");
+  // With MPI_IN_PLACE every rank contributes its block of recvbuf and sendcount and sendtype are ignored
+  call.Set([&] {
+    return CallInfo{-1, false,
+                    (sendbuf == MPI_IN_PLACE) ? PayloadBytes(recvcount, recvtype) : PayloadBytes(sendcount, sendtype)};
+  });
+  return PMPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+}
+
+int MPI_Allgatherv(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, const int recvcounts[],
+                   const int displs[], MPI_Datatype recvtype, MPI_Comm comm) {
+  ProfiledCall call("MPI_Allgatherv");
+  call.Set([&] {
+    return CallInfo{-1, false,
+                    (sendbuf == MPI_IN_PLACE) ? PayloadBytes(recvcounts[CommRank(comm)], recvtype)
+                                              : PayloadBytes(sendcount, sendtype)};
+  });
+  return PMPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs, recvtype, comm);
+}
+
+int MPI_Reduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, int root,
+               MPI_Comm comm) {
+  ProfiledCall call("MPI_Reduce");
+  call.Set([&] { return CallInfo{WorldRank(comm, root), false, PayloadBytes(count, datatype)}; });
+  return PMPI_Reduce(sendbuf, recvbuf, count, datatype, op, root, comm);
+}
+
+int MPI_Allreduce(const void *sendbuf, void *recvbuf, int count, MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
+  ProfiledCall call("MPI_Allreduce");
+  call.Set([&] { return CallInfo{-1, false, PayloadBytes(count, datatype)}; });
+  return PMPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
+}
+
+int MPI_Alltoall(const void *sendbuf, int sendcount, MPI_Datatype sendtype, void *recvbuf, int recvcount,
+                 MPI_Datatype recvtype, MPI_Comm comm) {
+  ProfiledCall call("MPI_Alltoall");
+  call.Set([&] { return CallInfo{-1, false, PayloadBytes(sendcount, sendtype)}; });
+  return PMPI_Alltoall(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, comm);
+}
+
+#else
+
+std::vector<ppc::util::MpiProfileEntry> ppc::util::TakeMpiProfile() {
+  return {};
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "util/include/mpi_threads.hpp"
+
+#include <mpi.h>
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "util/include/util.hpp"
+
+namespace {
+
+constexpr std::array<std::string_view, 4> kMpiThreadLevelNames = {"single", "funneled", "serialized", "multiple"};
+
+}  // namespace
+
+ppc::util::MpiThreadLevel ppc::util::ParseMpiThreadLevel(std::string_view name) {
+  for (std::size_t i = 0; i < kMpiThreadLevelNames.size(); i++) {
+    if (kMpiThreadLevelNames[i] == name) {
+      return static_cast<MpiThreadLevel>(i);
+    }
+  }
+  throw std::invalid_argument("Unknown MPI thread level: " + std::string(name));
+}
+
+std::string_view ppc::util::MpiThreadLevelName(MpiThreadLevel level) {
+  return kMpiThreadLevelNames[static_cast<std::size_t>(level)];
+}
+
+int ppc::util::ToMpiThreadConstant(MpiThreadLevel level) {
+  switch (level) {
+    case MpiThreadLevel::kSingle:
+      return MPI_THREAD_SINGLE;
+    case MpiThreadLevel::kFunneled:
+      return MPI_THREAD_FUNNELED;
+    case MpiThreadLevel::kSerialized:
+      return MPI_THREAD_SERIALIZED;
+    case MpiThreadLevel::kMultiple:
+      return MPI_THREAD_MULTIPLE;
+  }
+  return MPI_THREAD_SINGLE;
+}
+
+ppc::util::MpiThreadLevel ppc::util::FromMpiThreadConstant(int provided) {
+  // The MPI standard orders the constants, but does not fix their values
+  if (provided >= MPI_THREAD_MULTIPLE) {
+    return MpiThreadLevel::kMultiple;
+  }
+  if (provided >= MPI_THREAD_SERIALIZED) {
+    return MpiThreadLevel::kSerialized;
+  }
+  if (provided >= MPI_THREAD_FUNNELED) {
+    return MpiThreadLevel::kFunneled;
+  }
+  return MpiThreadLevel::kSingle;
+}
+
+ppc::util::MpiThreadLevel ppc::util::GetRequestedMpiThreadLevel() {
+  return ParseMpiThreadLevel(GetMpiThreadLevelName());
+}
+
+ppc::util::MpiThreadLevel ppc::util::GetMpiThreadLevel() {
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (initialized == 0) {
+    return MpiThreadLevel::kSingle;
+  }
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Query_thread(&provided);
+  return FromMpiThreadConstant(provided);
+}
@@ -0,0 +1,133 @@
+#include "util/include/node_shared.hpp"
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace {
+
+/// Broadcasts a byte range of any length in pieces that fit the int count of MPI
+void BcastBytes(std::byte *data, std::size_t bytes, int root, MPI_Comm comm) {
+  constexpr auto kChunk = static_cast<std::size_t>(std::numeric_limits<int>::max());
+  for (std::size_t offset = 0; offset < bytes; offset += kChunk) {
+    const std::size_t chunk = std::min(kChunk, bytes - offset);
+    MPI_Bcast(data + offset, static_cast<int>(chunk), MPI_BYTE, root, comm);
+  }
+}
+
+bool &ParityNodes() {
+  static bool parity = false;
+  return parity;
+}
+
+int &WorldRanksOnNode() {
+  static int ranks = 1;
+  return ranks;
+}
+
+}  // namespace
+
+void ppc::util::mpi::CountWorldRanksOnNode() {
+  MPI_Comm node_comm = MPI_COMM_NULL;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm);
+  MPI_Comm_size(node_comm, &WorldRanksOnNode());
+  MPI_Comm_free(&node_comm);
+}
+
+int ppc::util::mpi::GetWorldRanksOnNode() {
+  return WorldRanksOnNode();
+}
+
+ppc::util::mpi::ScopedParityNodes::ScopedParityNodes() : previous_(ParityNodes()) {
+  ParityNodes() = true;
+}
+
+ppc::util::mpi::ScopedParityNodes::~ScopedParityNodes() {
+  ParityNodes() = previous_;
+}
+
+ppc::util::mpi::SharedWindow::SharedWindow(std::size_t bytes, int root, MPI_Comm comm) : bytes_(bytes) {
+  int rank = 0;
+  int size = 0;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+  // The smallest key makes the root the leader of its node and rank 0 among the leaders
+  const int key = rank == root ? 0 : rank + 1;
+  if (ParityNodes()) {
+    // All ranks still run on one machine, so every emulated node can map a shared window
+    MPI_Comm_split(comm, rank % 2, key, &node_comm_);
+  } else {
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &node_comm_);
+  }
+  int node_rank = 0;
+  MPI_Comm_rank(node_comm_, &node_rank);
+  MPI_Comm_split(comm, node_rank == 0 ? 0 : MPI_UNDEFINED, key, &leader_comm_);
+
+  int node = 0;
+  if (IsLeader()) {
+    MPI_Comm_rank(leader_comm_, &node);
+    MPI_Comm_size(leader_comm_, &num_nodes_);
+  }
+  MPI_Bcast(&node, 1, MPI_INT, 0, node_comm_);
+  MPI_Bcast(&num_nodes_, 1, MPI_INT, 0, node_comm_);
+  node_of_rank_.resize(static_cast<std::size_t>(size));
+  MPI_Allgather(&node, 1, MPI_INT, node_of_rank_.data(), 1, MPI_INT, comm);
+
+  void *base = nullptr;
+  MPI_Win_allocate_shared(static_cast<MPI_Aint>(node_rank == 0 ? bytes : 0), 1, MPI_INFO_NULL, node_comm_, &base,
+                          &win_);
+  MPI_Aint leader_bytes = 0;
+  int disp_unit = 0;
+  void *leader_base = nullptr;
+  MPI_Win_shared_query(win_, 0, &leader_bytes, &disp_unit, &leader_base);
+  data_ = static_cast<std::byte *>(leader_base);
+  // A passive epoch for the lifetime of the window; Sync() orders the loads and stores within it
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+}
+
+ppc::util::mpi::SharedWindow::~SharedWindow() {
+  MPI_Win_unlock_all(win_);
+  MPI_Win_free(&win_);
+  if (leader_comm_ != MPI_COMM_NULL) {
+    MPI_Comm_free(&leader_comm_);
+  }
+  MPI_Comm_free(&node_comm_);
+}
+
+void ppc::util::mpi::SharedWindow::Sync() const {
+  MPI_Win_sync(win_);
+  MPI_Barrier(node_comm_);
+  MPI_Win_sync(win_);
+}
+
+void ppc::util::mpi::SharedWindow::BcastFromRoot() const {
+  Sync();
+  if (num_nodes_ == 1) {
+    return;
+  }
+  if (IsLeader()) {
+    BcastBytes(data_, bytes_, 0, leader_comm_);
+  }
+  Sync();
+}
+
+void ppc::util::mpi::SharedWindow::AllgatherRanges(std::span<const std::size_t> offsets,
+                                                   std::span<const std::size_t> counts) const {
+  Sync();
+  if (num_nodes_ == 1) {
+    return;
+  }
+  if (IsLeader()) {
+    // The leader of the node that owns a range has it in its buffer after the Sync() above
+    for (std::size_t rank = 0; rank < counts.size(); rank++) {
+      if (counts[rank] > 0) {
+        BcastBytes(data_ + offsets[rank], counts[rank], node_of_rank_[rank], leader_comm_);
+      }
+    }
+  }
+  Sync();
+}
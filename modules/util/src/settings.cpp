@@ -0,0 +1,75 @@
+#include "util/include/settings.hpp"
+
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+struct SettingsCache {
+  std::mutex mutex;
+  std::map<std::string, ppc::util::TaskSettings, std::less<>> settings;
+};
+
+SettingsCache &GetSettingsCache() {
+  static SettingsCache cache;
+  return cache;
+}
+
+}  // namespace
+
+ppc::util::TaskSettings::TaskSettings(std::string_view json_text, const std::string &path) : path_(path) {
+  const auto json = nlohmann::json::parse(json_text);
+  if (json.contains("tasks") && json["tasks"].is_object()) {
+    for (const auto &[technology, status] : json["tasks"].items()) {
+      statuses_.emplace(technology, status);
+    }
+  }
+  if (json.contains("tasks_type") && json["tasks_type"].is_string()) {
+    const auto &tasks_type = json["tasks_type"].get_ref<const std::string &>();
+    if (tasks_type == "processes") {
+      tasks_type_ = TasksType::kProcesses;
+    } else if (tasks_type == "threads") {
+      tasks_type_ = TasksType::kThreads;
+    }
+  }
+}
+
+const std::string &ppc::util::TaskSettings::GetStatus(std::string_view technology) const {
+  const auto status = statuses_.find(technology);
+  if (status == statuses_.end()) {
+    throw std::runtime_error("No status of " + std::string(technology) + " in " + path_);
+  }
+  return status->second.get_ref<const std::string &>();
+}
+
+bool ppc::util::TaskSettings::IsEnabled(std::string_view technology) const {
+  return GetStatus(technology) == "enabled";
+}
+
+ppc::util::TasksType ppc::util::TaskSettings::GetTasksType() const {
+  return tasks_type_;
+}
+
+const ppc::util::TaskSettings &ppc::util::GetTaskSettings(const std::string &path) {
+  auto &cache = GetSettingsCache();
+  const std::scoped_lock lock(cache.mutex);
+  const auto cached = cache.settings.find(path);
+  if (cached != cache.settings.end()) {
+    return cached->second;
+  }
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  std::stringstream contents;
+  contents << file.rdbuf();
+  // Map nodes never move, so the returned reference stays valid while other paths are added
+  return cache.settings.try_emplace(path, contents.str(), path).first->second;
+}
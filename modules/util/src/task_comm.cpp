@@ -0,0 +1,71 @@
+#include "util/include/task_comm.hpp"
+
+#include <mpi.h>
+
+#include <format>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+MPI_Comm &TaskParentComm() {
+  static MPI_Comm comm = MPI_COMM_WORLD;
+  return comm;
+}
+
+}  // namespace
+
+bool ppc::util::IsMpiActive() {
+  int initialized = 0;
+  int finalized = 0;
+  MPI_Initialized(&initialized);
+  MPI_Finalized(&finalized);
+  return initialized != 0 && finalized == 0;
+}
+
+MPI_Comm ppc::util::GetTaskParentComm() {
+  return TaskParentComm();
+}
+
+ppc::util::ScopedTaskParentComm::ScopedTaskParentComm(MPI_Comm comm) : previous_(TaskParentComm()) {
+  TaskParentComm() = comm;
+}
+
+ppc::util::ScopedTaskParentComm::~ScopedTaskParentComm() {
+  TaskParentComm() = previous_;
+}
+
+ppc::util::TaskComm::~TaskComm() {
+  Free();
+}
+
+MPI_Comm ppc::util::TaskComm::Get() {
+  if (comm_ == MPI_COMM_NULL) {
+    if (!IsMpiActive()) {
+      throw std::logic_error("A task communicator needs an initialized MPI");
+    }
+    MPI_Comm_dup(GetTaskParentComm(), &comm_);
+  }
+  return comm_;
+}
+
+bool ppc::util::TaskComm::Free() {
+  if (comm_ == MPI_COMM_NULL || !IsMpiActive()) {
+    comm_ = MPI_COMM_NULL;
+    return true;
+  }
+  // A local probe without a barrier finds the messages that have already arrived, which is the common leak
+  int flag = 0;
+  MPI_Status status;
+  MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &flag, &status);
+  if (flag != 0) {
+    int rank = -1;
+    MPI_Comm_rank(comm_, &rank);
+    std::cerr << std::format("[  PROCESS {}  ] [  ERROR  ] Task communicator has an unread message from process {} "
+                             "with tag {}",
+                             rank, status.MPI_SOURCE, status.MPI_TAG)
+              << '\n';
+  }
+  MPI_Comm_free(&comm_);
+  return flag == 0;
+}
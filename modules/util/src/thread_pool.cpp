@@ -0,0 +1,213 @@
+#include "util/include/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "util/include/util.hpp"
+
+namespace {
+
+// Pool and deque index of the calling worker thread; null on threads that do not belong to a pool
+thread_local ppc::util::ThreadPool *tls_pool = nullptr;
+thread_local std::size_t tls_worker = 0;
+
+struct GlobalThreadPool {
+  std::mutex mutex;
+  std::unique_ptr<ppc::util::ThreadPool> pool;
+};
+
+GlobalThreadPool &GetGlobalThreadPool() {
+  static GlobalThreadPool global;
+  return global;
+}
+
+}  // namespace
+
+// Completion counter of the jobs spawned by one ParallelFor() or ParallelReduce() call
+struct ppc::util::ThreadPool::JobGroup {
+  std::atomic<std::int64_t> pending{0};
+  std::atomic<bool> failed{false};
+  std::mutex mutex;
+  std::exception_ptr error;
+
+  // Runs a job unless another job of the group has already failed, keeping the first exception
+  void Execute(const std::function<void()> &job) {
+    if (failed.load(std::memory_order_relaxed)) {
+      return;
+    }
+    try {
+      job();
+    } catch (...) {
+      const std::scoped_lock lock(mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+      failed.store(true, std::memory_order_relaxed);
+    }
+  }
+};
+
+ppc::util::ThreadPool::ThreadPool(int num_threads) {
+  const auto num_workers = static_cast<std::size_t>(std::max(num_threads, 1) - 1);
+  queues_.reserve(num_workers);
+  for (std::size_t i = 0; i < num_workers; i++) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+  workers_.reserve(num_workers);
+  for (std::size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+ppc::util::ThreadPool::~ThreadPool() {
+  {
+    const std::scoped_lock lock(sleep_mutex_);
+    stop_ = true;
+  }
+  wake_up_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+int ppc::util::ThreadPool::GetNumThreads() const {
+  return static_cast<int>(workers_.size()) + 1;
+}
+
+std::int64_t ppc::util::ThreadPool::ChunkSize(std::int64_t size, std::int64_t grain) const {
+  if (grain > 0) {
+    return grain;
+  }
+  // A few jobs per thread leave room for stealing when the iterations are uneven
+  const std::int64_t jobs = std::int64_t{4} * GetNumThreads();
+  return std::max<std::int64_t>(1, (size + jobs - 1) / jobs);
+}
+
+std::int64_t ppc::util::ThreadPool::NumChunks(std::int64_t size, std::int64_t chunk) {
+  return (size > 0) ? (size + chunk - 1) / chunk : 0;
+}
+
+void ppc::util::ThreadPool::RunChunks(std::int64_t num_chunks, const std::function<void(std::int64_t)> &chunk_body) {
+  if (num_chunks <= 0) {
+    return;
+  }
+  if (workers_.empty() || num_chunks == 1) {
+    for (std::int64_t index = 0; index < num_chunks; index++) {
+      chunk_body(index);
+    }
+    return;
+  }
+  JobGroup group;
+  group.Execute([&] { SplitChunks(group, 0, num_chunks, chunk_body); });
+  // The caller helps instead of blocking, which also lets nested calls from inside a job make progress
+  while (group.pending.load(std::memory_order_acquire) > 0) {
+    if (!TryRunJob()) {
+      std::this_thread::yield();
+    }
+  }
+  if (group.error) {
+    std::rethrow_exception(group.error);
+  }
+}
+
+void ppc::util::ThreadPool::SplitChunks(JobGroup &group, std::int64_t first, std::int64_t last,
+                                        const std::function<void(std::int64_t)> &chunk_body) {
+  // Halving leaves the large upper halves at the front of the deque, where thieves take them
+  while (last - first > 1) {
+    const std::int64_t middle = first + ((last - first) / 2);
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    Spawn([this, &group, middle, last, &chunk_body] {
+      group.Execute([&] { SplitChunks(group, middle, last, chunk_body); });
+      // Last access to the group: the waiting caller may destroy it right after the decrement
+      group.pending.fetch_sub(1, std::memory_order_release);
+    });
+    last = middle;
+  }
+  chunk_body(first);
+}
+
+void ppc::util::ThreadPool::Spawn(Job job) {
+  const std::size_t target =
+      (tls_pool == this) ? tls_worker : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  queued_jobs_.fetch_add(1);
+  {
+    const std::scoped_lock lock(queues_[target]->mutex);
+    queues_[target]->jobs.push_back(std::move(job));
+  }
+  {
+    // Taking the lock orders the notification after a worker has checked the predicate and gone to sleep
+    const std::scoped_lock lock(sleep_mutex_);
+  }
+  wake_up_.notify_one();
+}
+
+bool ppc::util::ThreadPool::TryRunJob() {
+  Job job;
+  const bool is_worker = tls_pool == this;
+  if (is_worker) {
+    auto &own = *queues_[tls_worker];
+    const std::scoped_lock lock(own.mutex);
+    if (!own.jobs.empty()) {
+      job = std::move(own.jobs.back());
+      own.jobs.pop_back();
+    }
+  }
+  const std::size_t start = is_worker ? tls_worker + 1 : next_queue_.load(std::memory_order_relaxed);
+  for (std::size_t offset = 0; !job && offset < queues_.size(); offset++) {
+    auto &victim = *queues_[(start + offset) % queues_.size()];
+    const std::scoped_lock lock(victim.mutex);
+    if (!victim.jobs.empty()) {
+      job = std::move(victim.jobs.front());
+      victim.jobs.pop_front();
+    }
+  }
+  if (!job) {
+    return false;
+  }
+  queued_jobs_.fetch_sub(1);
+  job();
+  return true;
+}
+
+void ppc::util::ThreadPool::WorkerLoop(std::size_t index) {
+  tls_pool = this;
+  tls_worker = index;
+  while (true) {
+    if (TryRunJob()) {
+      continue;
+    }
+    std::unique_lock lock(sleep_mutex_);
+    wake_up_.wait(lock, [this] { return stop_ || queued_jobs_.load() > 0; });
+    if (stop_ && queued_jobs_.load() <= 0) {
+      return;
+    }
+  }
+}
+
+ppc::util::ThreadPool &ppc::util::GetThreadPool() {
+  if (tls_pool != nullptr) {
+    return *tls_pool;
+  }
+  auto &global = GetGlobalThreadPool();
+  const std::scoped_lock lock(global.mutex);
+  const int num_threads = std::max(GetNumThreads(), 1);
+  if (!global.pool || global.pool->GetNumThreads() != num_threads) {
+    global.pool.reset();
+    global.pool = std::make_unique<ThreadPool>(num_threads);
+  }
+  return *global.pool;
+}
+
+void ppc::util::ReleaseThreadPool() {
+  auto &global = GetGlobalThreadPool();
+  const std::scoped_lock lock(global.mutex);
+  global.pool.reset();
+}
@@ -0,0 +1,68 @@
+#include "util/include/thread_runtime.hpp"
+
+#include <omp.h>
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include "oneapi/tbb/global_control.h"
+#include "oneapi/tbb/parallel_for.h"
+#include "util/include/thread_pool.hpp"
+#include "util/include/util.hpp"
+
+namespace {
+
+struct ThreadRuntimeState {
+  std::atomic<ppc::util::ThreadRuntimeMode> mode{ppc::util::IsReleaseThreads()
+                                                     ? ppc::util::ThreadRuntimeMode::kReleaseAfterTask
+                                                     : ppc::util::ThreadRuntimeMode::kPersistent};
+  std::atomic<std::size_t> releases{0};
+};
+
+ThreadRuntimeState &GetThreadRuntimeState() {
+  static ThreadRuntimeState state;
+  return state;
+}
+
+}  // namespace
+
+ppc::util::ThreadRuntimeMode ppc::util::GetThreadRuntimeMode() {
+  return GetThreadRuntimeState().mode.load(std::memory_order_relaxed);
+}
+
+void ppc::util::SetThreadRuntimeMode(ThreadRuntimeMode mode) {
+  GetThreadRuntimeState().mode.store(mode, std::memory_order_relaxed);
+}
+
+void ppc::util::WarmUpThreadRuntime() {
+  const int num_threads = GetNumThreads();
+  // An empty region creates the OpenMP team, which the runtime keeps for the following regions
+#pragma omp parallel default(none) num_threads(num_threads)
+  {
+  }
+  // TBB starts its workers lazily on the first parallel algorithm
+  tbb::parallel_for(0, num_threads, [](int) {});
+  static_cast<void>(GetThreadPool());
+}
+
+void ppc::util::ReleaseThreadRuntime() {
+  ReleaseThreadPool();
+#if _OPENMP >= 201811
+  omp_pause_resource_all(omp_pause_soft);
+#endif
+  // Finalization joins the TBB workers; it is skipped without an error while another thread still uses TBB
+  tbb::task_scheduler_handle handle{tbb::attach{}};
+  static_cast<void>(tbb::finalize(handle, std::nothrow));
+  GetThreadRuntimeState().releases.fetch_add(1);
+}
+
+void ppc::util::OnTaskFinished() {
+  if (GetThreadRuntimeMode() == ThreadRuntimeMode::kReleaseAfterTask) {
+    ReleaseThreadRuntime();
+  }
+}
+
+std::size_t ppc::util::GetThreadRuntimeReleaseCount() {
+  return GetThreadRuntimeState().releases.load();
+}
@@ -0,0 +1,144 @@
+#include "util/include/trace.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "util/include/util.hpp"
+
+namespace {
+
+struct TraceEvent {
+  std::string name;
+  std::string category;
+  double begin_us = 0.0;
+  double duration_us = 0.0;
+  int thread_id = 0;
+};
+
+struct TraceState {
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+  std::atomic<bool> enabled{!ppc::util::GetTraceFile().empty()};
+  std::atomic<int> process_id{0};
+  std::atomic<int> next_thread_id{0};
+  std::atomic<std::chrono::steady_clock::rep> origin{std::chrono::steady_clock::now().time_since_epoch().count()};
+};
+
+TraceState &GetTraceState() {
+  static TraceState state;
+  return state;
+}
+
+// Small sequential ids read better in the timeline than hashed std::thread::id values
+int CurrentThreadId() {
+  thread_local const int kThreadId = GetTraceState().next_thread_id.fetch_add(1);
+  return kThreadId;
+}
+
+}  // namespace
+
+bool ppc::util::IsTracingEnabled() {
+  return GetTraceState().enabled.load(std::memory_order_relaxed);
+}
+
+void ppc::util::EnableTracing(bool enabled) {
+  GetTraceState().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void ppc::util::SetTraceProcess(int process_id) {
+  GetTraceState().process_id.store(process_id);
+}
+
+double ppc::util::TraceNowUs() {
+  const auto now = std::chrono::steady_clock::now().time_since_epoch();
+  const std::chrono::steady_clock::duration since_origin(
+      now.count() - GetTraceState().origin.load(std::memory_order_relaxed));
+  return std::chrono::duration<double, std::micro>(since_origin).count();
+}
+
+void ppc::util::ResetTraceClock() {
+  GetTraceState().origin.store(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+void ppc::util::RecordTraceEvent(std::string_view name, std::string_view category, double begin_us, double end_us) {
+  auto &state = GetTraceState();
+  TraceEvent event{.name = std::string(name),
+                   .category = std::string(category),
+                   .begin_us = begin_us,
+                   .duration_us = end_us - begin_us,
+                   .thread_id = CurrentThreadId()};
+  const std::scoped_lock lock(state.mutex);
+  state.events.push_back(std::move(event));
+}
+
+std::string ppc::util::TakeTraceEvents() {
+  auto &state = GetTraceState();
+  std::vector<TraceEvent> events;
+  {
+    const std::scoped_lock lock(state.mutex);
+    events.swap(state.events);
+  }
+  if (events.empty()) {
+    return {};
+  }
+  const int pid = state.process_id.load();
+  nlohmann::json process_name = {{"name", "process_name"},
+                                 {"ph", "M"},
+                                 {"pid", pid},
+                                 {"args", {{"name", "rank " + std::to_string(pid)}}}};
+  std::string serialized = process_name.dump();
+  for (const auto &event : events) {
+    const nlohmann::json json_event = {{"name", event.name}, {"cat", event.category}, {"ph", "X"},
+                                       {"ts", event.begin_us}, {"dur", event.duration_us}, {"pid", pid},
+                                       {"tid", event.thread_id}};
+    serialized += ',';
+    serialized += json_event.dump();
+  }
+  return serialized;
+}
+
+void ppc::util::WriteTraceFile(const std::string &path, const std::vector<std::string> &event_chunks) {
+  const std::filesystem::path file_path(path);
+  if (file_path.has_parent_path()) {
+    std::filesystem::create_directories(file_path.parent_path());
+  }
+  std::ofstream file(file_path);
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  file << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  bool first = true;
+  for (const auto &chunk : event_chunks) {
+    if (chunk.empty()) {
+      continue;
+    }
+    if (!first) {
+      file << ',';
+    }
+    file << chunk;
+    first = false;
+  }
+  file << "]}\n";
+}
+
+ppc::util::TraceScope::TraceScope(std::string name, std::string category)
+    : name_(std::move(name)), category_(std::move(category)) {
+  if (IsTracingEnabled()) {
+    begin_us_ = TraceNowUs();
+  }
+}
+
+ppc::util::TraceScope::~TraceScope() {
+  if (begin_us_ >= 0.0) {
+    RecordTraceEvent(name_, category_, begin_us_, TraceNowUs());
+  }
+}
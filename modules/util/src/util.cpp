@@ -1,11 +1,27 @@
 #include "util/include/util.hpp"
 
+#include <omp.h>
+
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
 #include <libenvpp/detail/get.hpp>
+#include <memory>
+#include <mutex>
 #include <string>
 
+#include "oneapi/tbb/global_control.h"
+
+#ifndef _WIN32
+#  include <unistd.h>
+#endif
+
+#ifndef PPC_GIT_REVISION
+#  define PPC_GIT_REVISION "unknown"
+#endif
+
 namespace {
 
 std::string GetAbsolutePath(const std::string &relative_path) {
@@ -13,6 +29,38 @@ std::string GetAbsolutePath(const std::string &relative_path) {
   return path.string();
 }
 
+// Process-wide thread configuration shared by GetNumThreads() and ScopedNumThreads
+struct ThreadLimits {
+  std::mutex mutex;
+  std::atomic<int> num_threads{0};
+  bool active = false;
+  int initial_omp_threads = 0;
+  std::unique_ptr<tbb::global_control> tbb_limit;
+};
+
+ThreadLimits &GetThreadLimits() {
+  static ThreadLimits limits;
+  return limits;
+}
+
+void ApplyThreadLimits(ThreadLimits &limits, int num_threads, bool active) {
+  if (!limits.active && active) {
+    limits.initial_omp_threads = omp_get_max_threads();
+  }
+  limits.num_threads.store(std::max(num_threads, 0));
+  limits.active = active;
+  if (!active) {
+    limits.tbb_limit.reset();
+    omp_set_num_threads(limits.initial_omp_threads);
+    return;
+  }
+  // Only one limit may be alive: TBB applies the smallest max_allowed_parallelism of all live controls
+  limits.tbb_limit.reset();
+  limits.tbb_limit = std::make_unique<tbb::global_control>(tbb::global_control::max_allowed_parallelism,
+                                                           ppc::util::GetNumThreads());
+  omp_set_num_threads((num_threads > 0) ? num_threads : limits.initial_omp_threads);
+}
+
 }  // namespace
 
 std::string ppc::util::GetAbsoluteTaskPath(const std::string &id_path, const std::string &relative_path) {
@@ -21,6 +69,10 @@ std::string ppc::util::GetAbsoluteTaskPath(const std::string &id_path, const std
 }
 
 int ppc::util::GetNumThreads() {
+  const int scoped_num_threads = GetThreadLimits().num_threads.load();
+  if (scoped_num_threads > 0) {
+    return scoped_num_threads;
+  }
   const auto num_threads = env::get<int>("PPC_NUM_THREADS");
   if (num_threads.has_value()) {
     return num_threads.value();
@@ -52,6 +104,151 @@ double ppc::util::GetPerfMaxTime() {
   return 10.0;
 }
 
+int ppc::util::GetPerfWarmupRuns() {
+  const auto val = env::get<int>("PPC_PERF_WARMUP");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return 0;
+}
+
+bool ppc::util::IsPerfAdaptive() {
+  const auto val = env::get<int>("PPC_PERF_ADAPTIVE");
+  return val.has_value() && val.value() != 0;
+}
+
+std::string ppc::util::GetPerfOutputDir() {
+  const auto val = env::get<std::string>("PPC_PERF_OUTPUT_DIR");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::string ppc::util::GetPerfOutputFormat() {
+  const auto val = env::get<std::string>("PPC_PERF_OUTPUT_FORMAT");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return "jsonl";
+}
+
+std::string ppc::util::GetHostName() {
+#ifdef _WIN32
+  const auto val = env::get<std::string>("COMPUTERNAME");
+  if (val.has_value()) {
+    return val.value();
+  }
+#else
+  std::array<char, 256> buffer{};
+  if (gethostname(buffer.data(), buffer.size() - 1) == 0) {
+    return std::string(buffer.data());
+  }
+#endif
+  return "unknown";
+}
+
+std::string ppc::util::GetGitRevision() {
+  // A runtime override wins over the revision captured at configure time
+  const auto val = env::get<std::string>("PPC_GIT_REVISION");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return PPC_GIT_REVISION;
+}
+
+std::string ppc::util::GetPerfBaselineFile() {
+  const auto val = env::get<std::string>("PPC_PERF_BASELINE_FILE");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+double ppc::util::GetPerfRegressionThreshold() {
+  const auto val = env::get<double>("PPC_PERF_REGRESSION_THRESHOLD");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return 0.5;
+}
+
+bool ppc::util::IsPerfBaselineUpdate() {
+  const auto val = env::get<int>("PPC_PERF_UPDATE_BASELINE");
+  return val.has_value() && val.value() != 0;
+}
+
+bool ppc::util::IsPerfThreadSweep() {
+  const auto val = env::get<int>("PPC_PERF_THREAD_SWEEP");
+  return val.has_value() && val.value() != 0;
+}
+
+bool ppc::util::IsPerfSizeSweep() {
+  const auto val = env::get<int>("PPC_PERF_SIZE_SWEEP");
+  return val.has_value() && val.value() != 0;
+}
+
+bool ppc::util::IsPerfColdCache() {
+  const auto val = env::get<int>("PPC_PERF_COLD_CACHE");
+  return val.has_value() && val.value() != 0;
+}
+
+bool ppc::util::IsPerfHardwareCounters() {
+  const auto val = env::get<int>("PPC_PERF_COUNTERS");
+  return val.has_value() && val.value() != 0;
+}
+
+std::string ppc::util::GetMpiThreadLevelName() {
+  const auto val = env::get<std::string>("PPC_MPI_THREAD_LEVEL");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return "funneled";
+}
+
+bool ppc::util::IsReleaseThreads() {
+  const auto val = env::get<int>("PPC_RELEASE_THREADS");
+  return val.has_value() && val.value() != 0;
+}
+
+std::string ppc::util::GetTraceFile() {
+  const auto val = env::get<std::string>("PPC_TRACE_FILE");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return {};
+}
+
+std::size_t ppc::util::GetCommBenchMaxBytes() {
+  const auto val = env::get<std::size_t>("PPC_COMM_BENCH_MAX_BYTES");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return std::size_t{256} << 20;
+}
+
+int ppc::util::GetRunnerGroups() {
+  const auto val = env::get<int>("PPC_RUNNER_GROUPS");
+  if (val.has_value()) {
+    return val.value();
+  }
+  return 1;
+}
+
+ppc::util::ScopedNumThreads::ScopedNumThreads(int num_threads) {
+  auto &limits = GetThreadLimits();
+  const std::scoped_lock lock(limits.mutex);
+  previous_num_threads_ = limits.num_threads.load();
+  previous_active_ = limits.active;
+  ApplyThreadLimits(limits, num_threads, true);
+}
+
+ppc::util::ScopedNumThreads::~ScopedNumThreads() {
+  auto &limits = GetThreadLimits();
+  const std::scoped_lock lock(limits.mutex);
+  ApplyThreadLimits(limits, previous_num_threads_, previous_active_);
+}
+
 // List of environment variables that signal the application is running under
 // an MPI launcher. The array size must match the number of entries to avoid
 // looking up empty environment variable names.
@@ -1,12 +1,36 @@
 #include "util/include/util.hpp"
 
 #include <gtest/gtest.h>
+#include <mpi.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <libenvpp/detail/environment.hpp>
 #include <libenvpp/detail/get.hpp>
+#include <new>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "omp.h"
+#include "oneapi/tbb/global_control.h"
+#include "util/include/alloc_tracker.hpp"
+#include "util/include/matrix.hpp"
+#include "util/include/mpi_collectives.hpp"
+#include "util/include/mpi_threads.hpp"
+#include "util/include/node_shared.hpp"
+#include "util/include/task_comm.hpp"
+#include "util/include/thread_pool.hpp"
+#include "util/include/thread_runtime.hpp"
+#include "util/include/trace.hpp"
 
 namespace my::nested {
 struct Type {};
@@ -23,6 +47,207 @@ TEST(UtilTests, ThreadsControlCheckOpenmpDisabledValgrind) {
   EXPECT_EQ(ppc::util::GetNumThreads(), omp_get_max_threads());
 }
 
+TEST(UtilTests, ScopedNumThreadsReconfiguresThreadCount) {
+  const int initial = ppc::util::GetNumThreads();
+  {
+    const ppc::util::ScopedNumThreads outer(3);
+    EXPECT_EQ(ppc::util::GetNumThreads(), 3);
+    EXPECT_EQ(omp_get_max_threads(), 3);
+    EXPECT_EQ(tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism), 3U);
+    {
+      const ppc::util::ScopedNumThreads inner(5);
+      EXPECT_EQ(ppc::util::GetNumThreads(), 5);
+      EXPECT_EQ(tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism), 5U);
+    }
+    EXPECT_EQ(ppc::util::GetNumThreads(), 3);
+    EXPECT_EQ(tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism), 3U);
+  }
+  EXPECT_EQ(ppc::util::GetNumThreads(), initial);
+}
+
+TEST(UtilTests, ThreadRuntimeReleasesWorkersOnlyInReleaseMode) {
+  const auto initial_mode = ppc::util::GetThreadRuntimeMode();
+  const std::size_t initial_releases = ppc::util::GetThreadRuntimeReleaseCount();
+
+  ppc::util::SetThreadRuntimeMode(ppc::util::ThreadRuntimeMode::kPersistent);
+  ppc::util::OnTaskFinished();
+  EXPECT_EQ(ppc::util::GetThreadRuntimeReleaseCount(), initial_releases);
+
+  ppc::util::SetThreadRuntimeMode(ppc::util::ThreadRuntimeMode::kReleaseAfterTask);
+  ppc::util::OnTaskFinished();
+  EXPECT_EQ(ppc::util::GetThreadRuntimeReleaseCount(), initial_releases + 1);
+  ppc::util::SetThreadRuntimeMode(initial_mode);
+
+  // Released runtimes start their workers again on the next parallel region
+  ppc::util::WarmUpThreadRuntime();
+  int team_size = 0;
+#pragma omp parallel default(none) shared(team_size) num_threads(2)
+  {
+#pragma omp single
+    team_size = omp_get_num_threads();
+  }
+  EXPECT_EQ(team_size, 2);
+}
+
+TEST(UtilTests, ThreadPoolRunsEveryIndexOnceAndReducesInOrder) {
+  ppc::util::ThreadPool pool(4);
+  EXPECT_EQ(pool.GetNumThreads(), 4);
+
+  std::vector<std::atomic<int>> visits(1000);
+  pool.ParallelFor(0, 1000, [&](std::int64_t i) { visits[static_cast<std::size_t>(i)]++; }, 7);
+  for (const auto &count : visits) {
+    EXPECT_EQ(count.load(), 1);
+  }
+
+  // Nested loops run on the same pool without deadlocking
+  std::atomic<int> nested(0);
+  pool.ParallelFor(0, 8, [&](std::int64_t /*i*/) { pool.ParallelFor(0, 8, [&](std::int64_t /*j*/) { nested++; }); });
+  EXPECT_EQ(nested.load(), 64);
+
+  const std::string digits = pool.ParallelReduce(
+      0, 10, std::string{},
+      [](std::int64_t begin, std::int64_t end, std::string init) {
+        for (std::int64_t i = begin; i < end; i++) {
+          init += std::to_string(i);
+        }
+        return init;
+      },
+      [](std::string lhs, const std::string &rhs) { return lhs + rhs; }, 1);
+  EXPECT_EQ(digits, "0123456789");
+
+  // Boolean partial results of neighbouring chunks are written concurrently, so a write lost to shared storage
+  // would leave a chunk at the identity
+  for (int round = 0; round < 20; round++) {
+    int true_partials = 0;
+    const bool any = pool.ParallelReduce(
+        0, 4096, false, [](std::int64_t /*begin*/, std::int64_t /*end*/, bool /*init*/) { return true; },
+        [&](bool lhs, bool rhs) {
+          true_partials += rhs ? 1 : 0;
+          return lhs || rhs;
+        },
+        1);
+    EXPECT_TRUE(any);
+    EXPECT_EQ(true_partials, 4096);
+  }
+}
+
+TEST(UtilTests, ThreadPoolRethrowsJobExceptions) {
+  ppc::util::ThreadPool pool(3);
+  EXPECT_THROW(pool.ParallelFor(0, 100,
+                                [](std::int64_t i) {
+                                  if (i == 42) {
+                                    throw std::runtime_error("job failed");
+                                  }
+                                },
+                                1),
+               std::runtime_error);
+  std::atomic<int> count(0);
+  pool.ParallelFor(0, 10, [&](std::int64_t /*i*/) { count++; });
+  EXPECT_EQ(count.load(), 10);
+}
+
+TEST(UtilTests, GlobalThreadPoolFollowsThreadCount) {
+  {
+    const ppc::util::ScopedNumThreads threads(3);
+    EXPECT_EQ(ppc::util::GetThreadPool().GetNumThreads(), 3);
+  }
+  EXPECT_EQ(ppc::util::GetThreadPool().GetNumThreads(), ppc::util::GetNumThreads());
+}
+
+TEST(UtilTests, MpiThreadLevelsRoundTrip) {
+  for (const auto *name : {"single", "funneled", "serialized", "multiple"}) {
+    const auto level = ppc::util::ParseMpiThreadLevel(name);
+    EXPECT_EQ(ppc::util::MpiThreadLevelName(level), name);
+    EXPECT_EQ(ppc::util::FromMpiThreadConstant(ppc::util::ToMpiThreadConstant(level)), level);
+  }
+  EXPECT_LT(ppc::util::MpiThreadLevel::kFunneled, ppc::util::MpiThreadLevel::kMultiple);
+  EXPECT_THROW(ppc::util::ParseMpiThreadLevel("parallel"), std::invalid_argument);
+
+  env::detail::set_scoped_environment_variable scoped("PPC_MPI_THREAD_LEVEL", "multiple");
+  EXPECT_EQ(ppc::util::GetRequestedMpiThreadLevel(), ppc::util::MpiThreadLevel::kMultiple);
+}
+
+TEST(UtilTests, MatrixViewsShareTheAlignedStorage) {
+  auto matrix = ppc::util::Matrix<int>::FromRows({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(matrix.Data()) % ppc::util::Matrix<int>::kAlignment, 0U);
+  EXPECT_TRUE(matrix.View().IsContiguous());
+  EXPECT_EQ(matrix(1, 2), 6);
+
+  auto tile = matrix.Tile(1, 1, 2, 2);
+  EXPECT_FALSE(tile.IsContiguous());
+  tile(1, 1) = 90;
+  EXPECT_EQ(matrix(2, 2), 90);
+  EXPECT_EQ(matrix.Block(1, 2).Row(0)[0], 4);
+  EXPECT_THROW(static_cast<void>(matrix.Tile(2, 2, 2, 1)), std::out_of_range);
+
+  const ppc::util::Matrix<double> padded(3, 5, 1.0, true);
+  EXPECT_EQ(padded.Stride() * sizeof(double) % ppc::util::Matrix<double>::kAlignment, 0U);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(padded.Row(2).data()) % ppc::util::Matrix<double>::kAlignment, 0U);
+
+  auto copy = matrix;
+  EXPECT_EQ(copy, matrix);
+  EXPECT_EQ(copy.ToRows(), (std::vector<std::vector<int>>{{1, 2, 3}, {4, 5, 6}, {7, 8, 90}}));
+  EXPECT_THROW(ppc::util::Matrix<int>::FromRows({{1, 2}, {3}}), std::invalid_argument);
+}
+
+TEST(UtilTests, AllocationCountersFollowOperatorNew) {
+  const auto before = ppc::util::GetAllocationCounters();
+  // A direct call cannot be elided by the optimizer, unlike a new-expression
+  void *ptr = ::operator new(4096);
+  const auto during = ppc::util::GetAllocationCounters();
+  ::operator delete(ptr);
+  const auto after = ppc::util::GetAllocationCounters();
+
+  if constexpr (ppc::util::IsAllocationTrackingEnabled()) {
+    EXPECT_EQ(during.allocations - before.allocations, 1U);
+    EXPECT_GE(during.allocated_bytes - before.allocated_bytes, 4096U);
+    EXPECT_GE(during.peak_live_bytes, during.live_bytes);
+    EXPECT_EQ(after.deallocations - during.deallocations, 1U);
+    EXPECT_EQ(after.live_bytes, before.live_bytes);
+  } else {
+    EXPECT_EQ(after.allocations, 0U);
+    EXPECT_EQ(after.allocated_bytes, 0U);
+  }
+}
+
+TEST(UtilTests, TraceScopesAreWrittenAsChromeTrace) {
+  const bool was_enabled = ppc::util::IsTracingEnabled();
+  static_cast<void>(ppc::util::TakeTraceEvents());
+  ppc::util::EnableTracing(true);
+  ppc::util::SetTraceProcess(3);
+  {
+    const ppc::util::TraceScope outer("outer_scope");
+    const ppc::util::TraceScope inner("inner_scope", "custom");
+  }
+  ppc::util::EnableTracing(false);
+  {
+    const ppc::util::TraceScope ignored("ignored_scope");
+  }
+  const std::string events = ppc::util::TakeTraceEvents();
+  ppc::util::EnableTracing(was_enabled);
+  ppc::util::SetTraceProcess(0);
+  EXPECT_TRUE(ppc::util::TakeTraceEvents().empty());
+
+  const auto path = std::filesystem::temp_directory_path() / "ppc_trace_test.json";
+  ppc::util::WriteTraceFile(path.string(), {events, ""});
+  std::ifstream file(path);
+  const auto trace = nlohmann::json::parse(file);
+  file.close();
+  std::filesystem::remove(path);
+
+  const auto &trace_events = trace.at("traceEvents");
+  ASSERT_EQ(trace_events.size(), 3U);
+  EXPECT_EQ(trace_events[0].at("ph"), "M");
+  EXPECT_EQ(trace_events[0].at("args").at("name"), "rank 3");
+  // The inner scope ends first
+  EXPECT_EQ(trace_events[1].at("name"), "inner_scope");
+  EXPECT_EQ(trace_events[1].at("cat"), "custom");
+  EXPECT_EQ(trace_events[2].at("name"), "outer_scope");
+  EXPECT_EQ(trace_events[2].at("pid"), 3);
+  EXPECT_LE(trace_events[2].at("ts").get<double>(), trace_events[1].at("ts").get<double>());
+  EXPECT_GE(trace_events[2].at("dur").get<double>(), trace_events[1].at("dur").get<double>());
+}
+
 namespace test_ns {
 struct TypeInNamespace {};
 }  // namespace test_ns
@@ -109,6 +334,21 @@ TEST(GetPerfMaxTime, ReadsFromEnvironment) {
   EXPECT_DOUBLE_EQ(ppc::util::GetPerfMaxTime(), 12.5);
 }
 
+TEST(GetPerfOutputFormat, ReadsFromEnvironment) {
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_OUTPUT_FORMAT", "csv");
+  EXPECT_EQ(ppc::util::GetPerfOutputFormat(), "csv");
+}
+
+TEST(GetGitRevision, ReadsOverrideFromEnvironment) {
+  env::detail::set_scoped_environment_variable scoped("PPC_GIT_REVISION", "abc1234");
+  EXPECT_EQ(ppc::util::GetGitRevision(), "abc1234");
+}
+
+TEST(GetPerfRegressionThreshold, ReadsFromEnvironment) {
+  env::detail::set_scoped_environment_variable scoped("PPC_PERF_REGRESSION_THRESHOLD", "0.25");
+  EXPECT_DOUBLE_EQ(ppc::util::GetPerfRegressionThreshold(), 0.25);
+}
+
 TEST(GetNumProc, ReturnsDefaultWhenUnset) {
   const auto old = env::get<int>("PPC_NUM_PROC");
   if (old.has_value()) {
@@ -124,3 +364,144 @@ TEST(GetNumProc, ReadsFromEnvironment) {
   env::detail::set_scoped_environment_variable scoped("PPC_NUM_PROC", "4");
   EXPECT_EQ(ppc::util::GetNumProc(), 4);
 }
+
+TEST(UtilTests, BlockPartitionBalancesBlocksAndClipsHalos) {
+  const ppc::util::mpi::BlockPartition partition(10, 4, 1);
+  EXPECT_EQ(partition.Counts(), (std::vector<int>{3, 3, 2, 2}));
+  EXPECT_EQ(partition.Displs(), (std::vector<int>{0, 3, 6, 8}));
+  EXPECT_EQ(partition.HaloCounts(), (std::vector<int>{4, 5, 4, 3}));
+  EXPECT_EQ(partition.HaloDispls(), (std::vector<int>{0, 2, 5, 7}));
+  EXPECT_EQ(partition.HaloShare(1, 0), (std::pair<std::size_t, std::size_t>{2, 1}));
+  EXPECT_EQ(partition.HaloShare(1, 2), (std::pair<std::size_t, std::size_t>{6, 1}));
+  EXPECT_EQ(partition.HaloShare(0, 2).second, 0U);
+  EXPECT_EQ(partition.HaloReach(), 1);
+  // A halo wider than the neighbouring block reaches the block behind it
+  EXPECT_EQ(ppc::util::mpi::BlockPartition(10, 4, 3).HaloReach(), 2);
+  EXPECT_EQ(ppc::util::mpi::BlockPartition(10, 4).HaloReach(), 0);
+
+  // Rows of 3 elements: counts are whole rows, parts without rows get no halo
+  const ppc::util::mpi::BlockPartition rows(2, 3, 1, 3);
+  EXPECT_EQ(rows.Total(), 6U);
+  EXPECT_EQ(rows.Counts(), (std::vector<int>{3, 3, 0}));
+  EXPECT_EQ(rows.HaloCounts(), (std::vector<int>{6, 6, 0}));
+  EXPECT_EQ(rows.HaloOffset(2), 6U);
+  EXPECT_EQ(rows.HaloShare(0, 1), (std::pair<std::size_t, std::size_t>{3, 3}));
+
+  EXPECT_THROW(ppc::util::mpi::BlockPartition(1, 0), std::invalid_argument);
+  EXPECT_THROW(ppc::util::mpi::BlockPartition(1, 1, 0, 0), std::invalid_argument);
+}
+
+TEST(UtilTests, MpiTypeMapsArithmeticTypes) {
+  EXPECT_EQ(ppc::util::mpi::GetMpiType<int>(), MPI_INT);
+  EXPECT_EQ(ppc::util::mpi::GetMpiType<const double>(), MPI_DOUBLE);
+  EXPECT_NE(ppc::util::mpi::GetMpiType<std::uint64_t>(), MPI_DATATYPE_NULL);
+  EXPECT_EQ(ppc::util::mpi::GetMpiType<bool>(), MPI_CXX_BOOL);
+}
+
+// The tests below need MPI, which only the runners of the task tests initialize
+TEST(UtilTests, ScatterBalancedFillsHalosFromNeighbours) {
+  if (!ppc::util::IsMpiActive()) {
+    GTEST_SKIP();
+  }
+  int size = 1;
+  int rank = 0;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  std::vector<int> data(33);
+  std::iota(data.begin(), data.end(), 1);
+  const auto send = rank == 0 ? std::span<const int>(data) : std::span<const int>();
+  // Single elements, rows of 3 and a halo wider than some blocks
+  for (const auto &partition :
+       {ppc::util::mpi::BlockPartition(data.size(), size, 2), ppc::util::mpi::BlockPartition(11, size, 1, 3),
+        ppc::util::mpi::BlockPartition(data.size(), size, 9)}) {
+    const auto local = ppc::util::mpi::ScatterBalanced(send, partition, 0, MPI_COMM_WORLD);
+    const auto expected =
+        std::span<const int>(data).subspan(partition.HaloOffset(rank), partition.HaloCount(rank));
+    EXPECT_TRUE(std::ranges::equal(local, expected));
+  }
+}
+
+TEST(UtilTests, NodeSharedArrayPlacesRootDataOnEveryNode) {
+  if (!ppc::util::IsMpiActive()) {
+    GTEST_SKIP();
+  }
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  const int root = size - 1;
+
+  for (const bool parity_nodes : {false, true}) {
+    std::optional<ppc::util::mpi::ScopedParityNodes> parity;
+    if (parity_nodes) {
+      parity.emplace();
+    }
+    std::vector<int> data;
+    if (rank == root) {
+      data.resize(37);
+      std::iota(data.begin(), data.end(), 5);
+    }
+    const ppc::util::mpi::NodeSharedArray<int> shared(std::span<const int>(data), root, MPI_COMM_WORLD);
+    ASSERT_EQ(shared.Size(), 37U);
+    for (std::size_t i = 0; i < shared.Size(); i++) {
+      EXPECT_EQ(shared.Span()[i], static_cast<int>(i) + 5);
+    }
+
+    const ppc::util::mpi::NodeSharedArray<int> empty(std::span<const int>(), root, MPI_COMM_WORLD);
+    EXPECT_EQ(empty.Size(), 0U);
+  }
+}
+
+TEST(UtilTests, SharedWindowHasOneLeaderPerNode) {
+  if (!ppc::util::IsMpiActive()) {
+    GTEST_SKIP();
+  }
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  const ppc::util::mpi::ScopedParityNodes parity;
+  const ppc::util::mpi::SharedWindow window(16, size - 1, MPI_COMM_WORLD);
+  EXPECT_EQ(window.NumNodes(), std::min(size, 2));
+  EXPECT_EQ(window.Bytes(), 16U);
+  if (rank == size - 1) {
+    EXPECT_TRUE(window.IsLeader());
+  }
+  int leaders = window.IsLeader() ? 1 : 0;
+  MPI_Allreduce(MPI_IN_PLACE, &leaders, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  EXPECT_EQ(leaders, window.NumNodes());
+}
+
+TEST(UtilTests, NodeSharedArrayAllgatherBlocksCompletesEveryNode) {
+  if (!ppc::util::IsMpiActive()) {
+    GTEST_SKIP();
+  }
+  int rank = 0;
+  int size = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+  for (const bool parity_nodes : {false, true}) {
+    std::optional<ppc::util::mpi::ScopedParityNodes> parity;
+    if (parity_nodes) {
+      parity.emplace();
+    }
+    // Rows of 3 elements, fewer rows than ranks on 4 and more processes
+    const ppc::util::mpi::BlockPartition rows(3, size, 0, 3);
+    ppc::util::mpi::NodeSharedArray<std::uint16_t> shared(rows.Total(), 0, MPI_COMM_WORLD);
+    // The window is reused, as by a task whose Run repeats
+    for (int round = 1; round <= 2; round++) {
+      const auto owned = shared.Span().subspan(rows.Offset(rank), rows.Count(rank));
+      for (std::size_t i = 0; i < owned.size(); i++) {
+        owned[i] = static_cast<std::uint16_t>((round * 100) + rows.Offset(rank) + i);
+      }
+      shared.AllgatherBlocks(rows);
+      for (std::size_t i = 0; i < shared.Size(); i++) {
+        EXPECT_EQ(shared.Span()[i], (round * 100) + i);
+      }
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
@@ -14,7 +14,7 @@ def init_cmd_args():
     parser.add_argument(
         "--running-type",
         required=True,
-        choices=["threads", "processes", "performance"],
+        choices=["threads", "processes", "performance", "comm_bench"],
         help="Specify the execution mode. Choose 'threads' for multithreading or 'processes' for multiprocessing.",
     )
     parser.add_argument(
@@ -266,6 +266,15 @@ class PPCRunner:
                 + self.__get_gtest_settings(1, "_" + task_type + "_")
             )
 
+    def run_comm_bench(self, additional_mpi_args):
+        ppc_num_proc = self.__ppc_env.get("PPC_NUM_PROC")
+        if ppc_num_proc is None:
+            raise EnvironmentError(
+                "Required environment variable 'PPC_NUM_PROC' is not set."
+            )
+        mpi_running = self.__build_mpi_cmd(ppc_num_proc, additional_mpi_args)
+        self.__run_exec(mpi_running + [str(self.work_dir / "ppc_comm_bench")])
+
 
 def _execute(args_dict, env):
     runner = PPCRunner(
@@ -283,6 +292,8 @@ def _execute(args_dict, env):
         runner.run_processes(args_dict["additional_mpi_args"])
     elif args_dict["running_type"] == "performance":
         runner.run_performance()
+    elif args_dict["running_type"] == "comm_bench":
+        runner.run_comm_bench(args_dict["additional_mpi_args"])
     else:
         raise Exception("running-type is wrong!")
 
@@ -298,7 +309,7 @@ if __name__ == "__main__":
             if args_dict["running_type"] == "threads":
                 env_copy["PPC_NUM_THREADS"] = str(count)
                 env_copy.setdefault("PPC_NUM_PROC", "1")
-            elif args_dict["running_type"] == "processes":
+            elif args_dict["running_type"] in ["processes", "comm_bench"]:
                 env_copy["PPC_NUM_PROC"] = str(count)
                 env_copy.setdefault("PPC_NUM_THREADS", "1")
 
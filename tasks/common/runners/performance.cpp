@@ -1,5 +1,6 @@
 #include "runners/include/runners.hpp"
 
 int main(int argc, char **argv) {
-  return ppc::runners::Init(argc, argv);
+  // Runner groups would share the machine while they measure
+  return ppc::runners::Init(argc, argv, false);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mpi.h>
+
 #include <vector>
 
 #include "dergynov_s_hypercube/common/include/common.hpp"
@@ -25,8 +27,8 @@ class DergynovSHypercubeMPI : public BaseTask {
   static std::vector<int> BuildPath(int src, int dst, int dim);
   static void FindPos(int rank, const std::vector<int> &path, int &pos, int &next, int &prev);
 
-  static void SendVec(const std::vector<int> &data, int to);
-  static void RecvVec(std::vector<int> &data, int from);
+  static void SendVec(MPI_Comm comm, const std::vector<int> &data, int to);
+  static void RecvVec(MPI_Comm comm, std::vector<int> &data, int from);
   static void BusyWork(int iters);
 };
 
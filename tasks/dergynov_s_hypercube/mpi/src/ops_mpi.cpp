@@ -62,20 +62,20 @@ void DergynovSHypercubeMPI::FindPos(int rank, const std::vector<int> &path, int
   }
 }
 
-void DergynovSHypercubeMPI::SendVec(const std::vector<int> &data, int to) {
+void DergynovSHypercubeMPI::SendVec(MPI_Comm comm, const std::vector<int> &data, int to) {
   int sz = static_cast<int>(data.size());
-  MPI_Send(&sz, 1, MPI_INT, to, 0, MPI_COMM_WORLD);
+  MPI_Send(&sz, 1, MPI_INT, to, 0, comm);
   if (sz > 0) {
-    MPI_Send(data.data(), sz, MPI_INT, to, 1, MPI_COMM_WORLD);
+    MPI_Send(data.data(), sz, MPI_INT, to, 1, comm);
   }
 }
 
-void DergynovSHypercubeMPI::RecvVec(std::vector<int> &data, int from) {
+void DergynovSHypercubeMPI::RecvVec(MPI_Comm comm, std::vector<int> &data, int from) {
   int sz = 0;
-  MPI_Recv(&sz, 1, MPI_INT, from, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  MPI_Recv(&sz, 1, MPI_INT, from, 0, comm, MPI_STATUS_IGNORE);
   data.resize(sz);
   if (sz > 0) {
-    MPI_Recv(data.data(), sz, MPI_INT, from, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Recv(data.data(), sz, MPI_INT, from, 1, comm, MPI_STATUS_IGNORE);
   }
 }
 
@@ -89,7 +89,7 @@ void DergynovSHypercubeMPI::BusyWork(int iters) {
 
 bool DergynovSHypercubeMPI::ValidationImpl() {
   int size = 0;
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_size(GetComm(), &size);
   auto &in = GetInput();
   if (in[0] < 0 || in[0] >= size) {
     in[0] = 0;
@@ -108,8 +108,8 @@ bool DergynovSHypercubeMPI::PreProcessingImpl() {
 bool DergynovSHypercubeMPI::RunImpl() {
   int rank = 0;
   int size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   const auto &in = GetInput();
   int src = in[0];
@@ -122,11 +122,11 @@ bool DergynovSHypercubeMPI::RunImpl() {
   }
 
   if (src == dst) {
-    MPI_Bcast(&data_size, 1, MPI_INT, dst, MPI_COMM_WORLD);
+    MPI_Bcast(&data_size, 1, MPI_INT, dst, GetComm());
     if (rank != dst) {
       data.resize(data_size);
     }
-    MPI_Bcast(data.data(), data_size, MPI_INT, dst, MPI_COMM_WORLD);
+    MPI_Bcast(data.data(), data_size, MPI_INT, dst, GetComm());
     GetOutput() = std::accumulate(data.begin(), data.end(), 0);
     return true;
   }
@@ -142,26 +142,26 @@ bool DergynovSHypercubeMPI::RunImpl() {
   if (pos != -1) {
     if (rank == src) {
       BusyWork(120000);
-      SendVec(data, next);
+      SendVec(GetComm(), data, next);
     } else if (rank == dst) {
-      RecvVec(data, prev);
+      RecvVec(GetComm(), data, prev);
       BusyWork(120000);
     } else {
-      RecvVec(data, prev);
+      RecvVec(GetComm(), data, prev);
       BusyWork(120000);
-      SendVec(data, next);
+      SendVec(GetComm(), data, next);
     }
   }
 
   int final_size = static_cast<int>(data.size());
-  MPI_Bcast(&final_size, 1, MPI_INT, dst, MPI_COMM_WORLD);
+  MPI_Bcast(&final_size, 1, MPI_INT, dst, GetComm());
   if (pos == -1) {
     data.resize(final_size);
   }
-  MPI_Bcast(data.data(), final_size, MPI_INT, dst, MPI_COMM_WORLD);
+  MPI_Bcast(data.data(), final_size, MPI_INT, dst, GetComm());
 
   GetOutput() = std::accumulate(data.begin(), data.end(), 0);
-  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Barrier(GetComm());
   return true;
 }
 
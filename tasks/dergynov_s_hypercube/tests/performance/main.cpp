@@ -5,6 +5,7 @@
 #include "dergynov_s_hypercube/mpi/include/ops_mpi.hpp"
 #include "dergynov_s_hypercube/seq/include/ops_seq.hpp"
 #include "util/include/perf_test_util.hpp"
+#include "util/include/task_comm.hpp"
 
 namespace dergynov_s_hypercube {
 namespace {
@@ -13,7 +14,7 @@ class DergynovSHypercubePerfTests : public ppc::util::BaseRunPerfTests<InType, O
  protected:
   void SetUp() override {
     int size = 0;
-    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    MPI_Comm_size(ppc::util::GetTaskParentComm(), &size);
     input_ = {0, size - 1, kDataSize_};
   }
 
@@ -97,13 +97,13 @@ bool DergynovSRadixSortDoubleSimpleMergeMPI::PreProcessingImpl() {
 bool DergynovSRadixSortDoubleSimpleMergeMPI::RunImpl() {
   int rank = 0;
   int size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   const auto &input = GetInput();
   int n = static_cast<int>(input.size());
 
-  MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&n, 1, MPI_INT, 0, GetComm());
 
   std::vector<int> counts(size);
   std::vector<int> displs(size);
@@ -121,7 +121,7 @@ bool DergynovSRadixSortDoubleSimpleMergeMPI::RunImpl() {
   std::vector<double> local_data(counts[rank]);
 
   MPI_Scatterv(rank == 0 ? input.data() : nullptr, counts.data(), displs.data(), MPI_DOUBLE, local_data.data(),
-               counts[rank], MPI_DOUBLE, 0, MPI_COMM_WORLD);
+               counts[rank], MPI_DOUBLE, 0, GetComm());
 
   RadixSortDoubles(local_data);
 
@@ -130,15 +130,15 @@ bool DergynovSRadixSortDoubleSimpleMergeMPI::RunImpl() {
 
     for (int proc = 1; proc < size; ++proc) {
       int recv_count = 0;
-      MPI_Recv(&recv_count, 1, MPI_INT, proc, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      MPI_Recv(&recv_count, 1, MPI_INT, proc, 0, GetComm(), MPI_STATUS_IGNORE);
       std::vector<double> part(recv_count);
-      MPI_Recv(part.data(), recv_count, MPI_DOUBLE, proc, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      MPI_Recv(part.data(), recv_count, MPI_DOUBLE, proc, 1, GetComm(), MPI_STATUS_IGNORE);
       result_ = MergeSorted(result_, part);
     }
   } else {
     int send_count = static_cast<int>(local_data.size());
-    MPI_Send(&send_count, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
-    MPI_Send(local_data.data(), send_count, MPI_DOUBLE, 0, 1, MPI_COMM_WORLD);
+    MPI_Send(&send_count, 1, MPI_INT, 0, 0, GetComm());
+    MPI_Send(local_data.data(), send_count, MPI_DOUBLE, 0, 1, GetComm());
   }
 
   std::get<1>(GetOutput()) = rank;
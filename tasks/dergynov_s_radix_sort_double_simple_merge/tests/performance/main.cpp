@@ -1,75 +1,75 @@
 #include <gtest/gtest.h>
-#include <mpi.h>
 
 #include <algorithm>
 #include <cstddef>
 #include <random>
+#include <tuple>
 #include <vector>
 
+#include "dergynov_s_radix_sort_double_simple_merge/common/include/common.hpp"
 #include "dergynov_s_radix_sort_double_simple_merge/mpi/include/ops_mpi.hpp"
 #include "dergynov_s_radix_sort_double_simple_merge/seq/include/ops_seq.hpp"
+#include "util/include/perf_test_util.hpp"
 
 namespace dergynov_s_radix_sort_double_simple_merge {
+
 namespace {
 
-template <typename T>
-void ValidateTask(T &task) {
-  ASSERT_TRUE(task.Validation());
-}
+constexpr std::size_t kDataSize = 1000000;
 
-template <typename T>
-void ProcessTask(T &task) {
-  ASSERT_TRUE(task.PreProcessing());
-  ASSERT_TRUE(task.Run());
-  ASSERT_TRUE(task.PostProcessing());
+InType GenerateInput(std::size_t size) {
+  InType data(size);
+  std::random_device rd;
+  std::mt19937 gen(rd());
+  std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+  for (std::size_t i = 0; i < size; ++i) {
+    data[i] = dist(gen);
+  }
+  return data;
 }
 
-template <typename T>
-void ValidateAndProcess(T &task) {
-  ValidateTask(task);
-  ProcessTask(task);
-}
+}  // namespace
 
-template <typename T>
-void CheckSortedAndSize(T &task, const std::vector<double> &data) {
-  auto sorted = std::get<0>(task.GetOutput());
-  EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
-  EXPECT_EQ(sorted.size(), data.size());
-}
+class DergynovRadixSortPerfTests : public ppc::util::BaseRunPerfTests<InType, OutType> {
+  InType input_data_;
 
-class DergynovRadixSortPerfTests : public ::testing::Test {
- protected:
   void SetUp() override {
-    const size_t k_data_size = 1000000;
-    data.resize(k_data_size);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
-    for (size_t i = 0; i < k_data_size; ++i) {
-      data[i] = dist(gen);
+    input_data_ = GenerateInput(kDataSize);
+  }
+
+  bool CheckTestOutputData(OutType &output_data) final {
+    // Only the root process holds the merged result
+    if (std::get<1>(output_data) != 0) {
+      return true;
     }
+    const auto &sorted = std::get<0>(output_data);
+    return sorted.size() == input_data_.size() && std::ranges::is_sorted(sorted);
   }
 
-  std::vector<double> data;
+  InType GetTestInputData() final {
+    return input_data_;
+  }
+
+  std::vector<std::size_t> GetTestInputSizes() final {
+    return ppc::performance::SizeLadder(kDataSize, 4);
+  }
+
+  InType GetTestInputDataOfSize(std::size_t size) final {
+    return GenerateInput(size);
+  }
 };
 
-TEST_F(DergynovRadixSortPerfTests, SeqPerformance) {
-  DergynovSRadixSortDoubleSimpleMergeSEQ task(data);
-  ValidateAndProcess(task);
-  CheckSortedAndSize(task, data);
+TEST_P(DergynovRadixSortPerfTests, RunPerfModes) {
+  ExecuteTest(GetParam());
 }
 
-TEST_F(DergynovRadixSortPerfTests, MpiPerformance) {
-  int rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+const auto kAllPerfTasks =
+    ppc::util::MakeAllPerfTasks<InType, DergynovSRadixSortDoubleSimpleMergeMPI, DergynovSRadixSortDoubleSimpleMergeSEQ>(
+        PPC_SETTINGS_dergynov_s_radix_sort_double_simple_merge);
 
-  DergynovSRadixSortDoubleSimpleMergeMPI task(data);
-  ValidateAndProcess(task);
+const auto kGtestValues = ppc::util::TupleToGTestValues(kAllPerfTasks);
+const auto kPerfTestName = DergynovRadixSortPerfTests::CustomPerfTestName;
 
-  if (rank == 0) {
-    CheckSortedAndSize(task, data);
-  }
-}
+INSTANTIATE_TEST_SUITE_P(RunModeTests, DergynovRadixSortPerfTests, kGtestValues, kPerfTestName);
 
-}  // namespace
 }  // namespace dergynov_s_radix_sort_double_simple_merge
@@ -27,11 +27,11 @@ bool DergynovSTrapezoidIntegrationMPI::PreProcessingImpl() {
 bool DergynovSTrapezoidIntegrationMPI::RunImpl() {
   int rank = 0;
   int size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   InType in = (rank == 0) ? GetInput() : InType{};
-  MPI_Bcast(&in, sizeof(InType), MPI_BYTE, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&in, sizeof(InType), MPI_BYTE, 0, GetComm());
   GetInput() = in;
 
   const double a = in.a;
@@ -61,8 +61,8 @@ bool DergynovSTrapezoidIntegrationMPI::RunImpl() {
   }
 
   double global_sum = 0.0;
-  MPI_Reduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-  MPI_Bcast(&global_sum, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, 0, GetComm());
+  MPI_Bcast(&global_sum, 1, MPI_DOUBLE, 0, GetComm());
 
   GetOutput() = global_sum;
   return true;
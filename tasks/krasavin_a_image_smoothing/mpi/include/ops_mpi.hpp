@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "krasavin_a_image_smoothing/common/include/common.hpp"
 #include "task/include/task.hpp"
+#include "util/include/node_shared.hpp"
 
 namespace krasavin_a_image_smoothing {
 
@@ -12,7 +15,7 @@ class KrasavinAImageSmoothingMPI : public BaseTask {
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
     return ppc::task::TypeOfTask::kMPI;
   }
-  explicit KrasavinAImageSmoothingMPI(const InType &in);
+  explicit KrasavinAImageSmoothingMPI(InType in);
 
  private:
   bool ValidationImpl() override;
@@ -21,6 +24,8 @@ class KrasavinAImageSmoothingMPI : public BaseTask {
   bool PostProcessingImpl() override;
 
   std::vector<std::vector<float>> gaussian_kernel_;
+  /// Smoothed pixels, shared by the ranks of a node
+  std::optional<ppc::util::mpi::NodeSharedArray<uint8_t>> result_;
 };
 
 }  // namespace krasavin_a_image_smoothing
@@ -12,7 +12,7 @@ class KrasavinAImageSmoothingSEQ : public BaseTask {
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
     return ppc::task::TypeOfTask::kSEQ;
   }
-  explicit KrasavinAImageSmoothingSEQ(const InType &in);
+  explicit KrasavinAImageSmoothingSEQ(InType in);
 
  private:
   bool ValidationImpl() override;
@@ -11,9 +11,9 @@
 
 namespace krasavin_a_image_smoothing {
 
-KrasavinAImageSmoothingSEQ::KrasavinAImageSmoothingSEQ(const InType &in) {
+KrasavinAImageSmoothingSEQ::KrasavinAImageSmoothingSEQ(InType in) {
   SetTypeOfTask(GetStaticTypeOfTask());
-  GetInput() = in;
+  GetInput() = std::move(in);
   GetOutput() = Image();
 }
 
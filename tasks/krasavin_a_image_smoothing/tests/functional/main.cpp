@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <random>
 #include <string>
 #include <tuple>
@@ -11,6 +13,7 @@
 #include "krasavin_a_image_smoothing/mpi/include/ops_mpi.hpp"
 #include "krasavin_a_image_smoothing/seq/include/ops_seq.hpp"
 #include "util/include/func_test_util.hpp"
+#include "util/include/node_shared.hpp"
 #include "util/include/util.hpp"
 
 namespace krasavin_a_image_smoothing {
@@ -132,6 +135,31 @@ const auto kPerfTestName = KrasavinARunFuncTestsProcesses2::PrintFuncTestName<Kr
 
 INSTANTIATE_TEST_SUITE_P(ImageSmoothingTests, KrasavinARunFuncTestsProcesses2, kGtestValues, kPerfTestName);
 
+TEST(KrasavinAImageSmoothingEmulatedNodes, MpiMatchesSeqAcrossNodes) {
+  if (!ppc::util::IsUnderMpirun()) {
+    GTEST_SKIP();
+  }
+  // Even and odd ranks form two nodes, so the result rows travel between node leaders
+  const ppc::util::mpi::ScopedParityNodes parity_nodes;
+
+  Image image{.data = {}, .width = 23, .height = 17, .channels = 3};
+  image.data.resize(image.width * image.height * image.channels);
+  for (size_t i = 0; i < image.data.size(); i++) {
+    image.data[i] = static_cast<uint8_t>((i * 37) % 251);
+  }
+
+  KrasavinAImageSmoothingSEQ seq_task(image);
+  ASSERT_TRUE(seq_task.Validation() && seq_task.PreProcessing() && seq_task.Run() && seq_task.PostProcessing());
+  const auto &expected = seq_task.GetOutput().data;
+
+  KrasavinAImageSmoothingMPI mpi_task(image);
+  ASSERT_TRUE(mpi_task.Validation() && mpi_task.PreProcessing() && mpi_task.Run());
+  // Later runs reuse the result window allocated before the first one
+  ASSERT_TRUE(mpi_task.Run() && mpi_task.PostProcessing());
+  const auto &actual = mpi_task.GetOutput().data;
+  EXPECT_TRUE(std::ranges::equal(actual, expected));
+}
+
 }  // namespace
 
 }  // namespace krasavin_a_image_smoothing
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include "krasavin_a_image_smoothing/common/include/common.hpp"
@@ -14,6 +15,7 @@ namespace krasavin_a_image_smoothing {
 class KrasavinARunPerfTestProcesses2 : public ppc::util::BaseRunPerfTests<InType, OutType> {
   InType input_data_;
   float preprocess_blur_value_ = 0.0F;
+  uint64_t num_samples_ = 0;
 
   void SetUp() override {
     size_t width = 7680;
@@ -25,6 +27,7 @@ class KrasavinARunPerfTestProcesses2 : public ppc::util::BaseRunPerfTests<InType
     input_data_.channels = channels;
 
     input_data_.data.resize(width * height * channels);
+    num_samples_ = width * height * channels;
 
     for (size_t col = 0; col < width; col += channels) {
       for (size_t row = 0; row < height; row += channels) {
@@ -104,7 +107,16 @@ class KrasavinARunPerfTestProcesses2 : public ppc::util::BaseRunPerfTests<InType
   }
 
   InType GetTestInputData() final {
-    return input_data_;
+    return std::move(input_data_);
+  }
+
+  void SetPerfAttributes(ppc::performance::PerfAttr &perf_attrs) final {
+    BaseRunPerfTests::SetPerfAttributes(perf_attrs);
+    // Every output sample reads one input sample from memory (the 5x5 window is served by the caches)
+    // and costs a multiply-add per kernel weight
+    constexpr uint64_t kKernelWeights = 25;
+    perf_attrs.bytes_moved = 2 * num_samples_;
+    perf_attrs.flops = 2 * kKernelWeights * num_samples_;
   }
 };
 
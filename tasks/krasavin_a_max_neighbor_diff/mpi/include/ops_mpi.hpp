@@ -10,7 +10,7 @@ class KrasavinAMaxNeighborDiffMPI : public BaseTask {
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
     return ppc::task::TypeOfTask::kMPI;
   }
-  explicit KrasavinAMaxNeighborDiffMPI(const InType &in);
+  explicit KrasavinAMaxNeighborDiffMPI(InType in);
 
  private:
   bool ValidationImpl() override;
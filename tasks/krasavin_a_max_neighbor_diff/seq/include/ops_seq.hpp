@@ -10,7 +10,7 @@ class KrasavinAMaxNeighborDiffSEQ : public BaseTask {
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
     return ppc::task::TypeOfTask::kSEQ;
   }
-  explicit KrasavinAMaxNeighborDiffSEQ(const InType &in);
+  explicit KrasavinAMaxNeighborDiffSEQ(InType in);
 
  private:
   bool ValidationImpl() override;
@@ -3,15 +3,16 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <utility>
 #include <vector>
 
 #include "krasavin_a_max_neighbor_diff/common/include/common.hpp"
 
 namespace krasavin_a_max_neighbor_diff {
 
-KrasavinAMaxNeighborDiffSEQ::KrasavinAMaxNeighborDiffSEQ(const InType &in) {
+KrasavinAMaxNeighborDiffSEQ::KrasavinAMaxNeighborDiffSEQ(InType in) {
   SetTypeOfTask(GetStaticTypeOfTask());
-  GetInput() = in;
+  GetInput() = std::move(in);
   GetOutput() = 0;
 }
 
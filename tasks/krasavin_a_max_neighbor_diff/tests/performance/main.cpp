@@ -2,7 +2,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "krasavin_a_max_neighbor_diff/common/include/common.hpp"
 #include "krasavin_a_max_neighbor_diff/mpi/include/ops_mpi.hpp"
@@ -11,25 +15,36 @@
 
 namespace krasavin_a_max_neighbor_diff {
 
-class KrasavinAMaxNeighborDiffPerfTests : public ppc::util::BaseRunPerfTests<InType, OutType> {
- protected:
-  void SetUp() override {
-    const int k_vector_size = 200000000;
+namespace {
 
-    input_data_.resize(k_vector_size);
+constexpr int kVectorSize = 200000000;
 
-    std::random_device random;
-    std::mt19937 gen(random());
-    std::uniform_int_distribution<int> small_dist(0, 100);
-    std::uniform_int_distribution<int> large_dist(1000, 10000);
+InType GenerateInput(std::size_t size) {
+  InType input(size);
 
-    for (int i = 0; i < k_vector_size; i++) {
-      if (i % 2 == 0) {
-        input_data_[i] = small_dist(gen);
-      } else {
-        input_data_[i] = large_dist(gen);
-      }
+  std::random_device random;
+  std::mt19937 gen(random());
+  std::uniform_int_distribution<int> small_dist(0, 100);
+  std::uniform_int_distribution<int> large_dist(1000, 10000);
+
+  for (std::size_t i = 0; i < size; i++) {
+    if (i % 2 == 0) {
+      input[i] = small_dist(gen);
+    } else {
+      input[i] = large_dist(gen);
     }
+  }
+  return input;
+}
+
+}  // namespace
+
+class KrasavinAMaxNeighborDiffPerfTests : public ppc::util::BaseRunPerfTests<InType, OutType> {
+ protected:
+  void SetUp() override {
+    const int k_vector_size = kVectorSize;
+
+    input_data_ = GenerateInput(k_vector_size);
 
     expected_max_diff_ = 0;
     for (int i = 0; i < k_vector_size - 1; i++) {
@@ -43,12 +58,29 @@ class KrasavinAMaxNeighborDiffPerfTests : public ppc::util::BaseRunPerfTests<InT
   }
 
   InType GetTestInputData() final {
-    return input_data_;
+    return std::move(input_data_);
+  }
+
+  std::vector<std::size_t> GetTestInputSizes() final {
+    return ppc::performance::SizeLadder(kVectorSize, 4);
+  }
+
+  InType GetTestInputDataOfSize(std::size_t size) final {
+    input_size_ = size;
+    return GenerateInput(size);
+  }
+
+  void SetPerfAttributes(ppc::performance::PerfAttr &perf_attrs) final {
+    BaseRunPerfTests::SetPerfAttributes(perf_attrs);
+    // Run() streams through the vector once; the comparisons are integer operations
+    perf_attrs.bytes_moved = static_cast<uint64_t>(input_size_) * sizeof(int);
   }
 
  private:
   InType input_data_;
   int expected_max_diff_ = 0;
+  /// Elements of the input of the measured task, including the size sweep steps
+  std::size_t input_size_ = kVectorSize;
 };
 
 TEST_P(KrasavinAMaxNeighborDiffPerfTests, RunPerfModes) {
@@ -10,7 +10,7 @@ class KulikovDiffCountNumberCharMPI : public BaseTask {
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
     return ppc::task::TypeOfTask::kMPI;
   }
-  explicit KulikovDiffCountNumberCharMPI(const InType &in);
+  explicit KulikovDiffCountNumberCharMPI(InType in);
 
  private:
   int proc_rank_{0};
@@ -12,12 +12,12 @@
 
 namespace kulikov_d_coun_number_char {
 
-KulikovDiffCountNumberCharMPI::KulikovDiffCountNumberCharMPI(const InType &in) {
-  MPI_Comm_rank(MPI_COMM_WORLD, &proc_rank_);
-  MPI_Comm_size(MPI_COMM_WORLD, &proc_size_);
+KulikovDiffCountNumberCharMPI::KulikovDiffCountNumberCharMPI(InType in) {
+  MPI_Comm_rank(GetComm(), &proc_rank_);
+  MPI_Comm_size(GetComm(), &proc_size_);
 
   SetTypeOfTask(GetStaticTypeOfTask());
-  GetInput() = in;
+  GetInput() = std::move(in);
   GetOutput() = 0;
 }
 
@@ -43,8 +43,8 @@ bool KulikovDiffCountNumberCharMPI::RunImpl() {
     len2 = s2.size();
   }
 
-  MPI_Bcast(&len1, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
-  MPI_Bcast(&len2, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&len1, 1, MPI_UNSIGNED_LONG, 0, GetComm());
+  MPI_Bcast(&len2, 1, MPI_UNSIGNED_LONG, 0, GetComm());
 
   const size_t min_len = std::min(len1, len2);
   const size_t max_len = std::max(len1, len2);
@@ -63,8 +63,8 @@ bool KulikovDiffCountNumberCharMPI::RunImpl() {
     }
   }
 
-  MPI_Bcast(send_counts.data(), proc_size_, MPI_INT, 0, MPI_COMM_WORLD);
-  MPI_Bcast(displs.data(), proc_size_, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(send_counts.data(), proc_size_, MPI_INT, 0, GetComm());
+  MPI_Bcast(displs.data(), proc_size_, MPI_INT, 0, GetComm());
 
   const size_t local_size = base + (std::cmp_less(proc_rank_, rem) ? 1 : 0);
 
@@ -72,10 +72,10 @@ bool KulikovDiffCountNumberCharMPI::RunImpl() {
   std::vector<char> local_s2(local_size);
 
   MPI_Scatterv(proc_rank_ == 0 ? const_cast<char *>(s1.data()) : nullptr, send_counts.data(), displs.data(), MPI_CHAR,
-               local_s1.data(), static_cast<int>(local_size), MPI_CHAR, 0, MPI_COMM_WORLD);
+               local_s1.data(), static_cast<int>(local_size), MPI_CHAR, 0, GetComm());
 
   MPI_Scatterv(proc_rank_ == 0 ? const_cast<char *>(s2.data()) : nullptr, send_counts.data(), displs.data(), MPI_CHAR,
-               local_s2.data(), static_cast<int>(local_size), MPI_CHAR, 0, MPI_COMM_WORLD);
+               local_s2.data(), static_cast<int>(local_size), MPI_CHAR, 0, GetComm());
 
   int local_diff = 0;
   for (size_t i = 0; i < local_size; ++i) {
@@ -85,7 +85,7 @@ bool KulikovDiffCountNumberCharMPI::RunImpl() {
   }
 
   int global_diff = 0;
-  MPI_Allreduce(&local_diff, &global_diff, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(&local_diff, &global_diff, 1, MPI_INT, MPI_SUM, GetComm());
   GetOutput() = global_diff + static_cast<int>(max_len - min_len);
   return true;
 }
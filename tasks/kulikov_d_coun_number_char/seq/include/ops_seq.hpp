@@ -10,7 +10,7 @@ class KulikovDiffCountNumberCharSEQ : public BaseTask {
   static constexpr ppc::task::TypeOfTask GetStaticTypeOfTask() {
     return ppc::task::TypeOfTask::kSEQ;
   }
-  explicit KulikovDiffCountNumberCharSEQ(const InType &in);
+  explicit KulikovDiffCountNumberCharSEQ(InType in);
 
  private:
   bool ValidationImpl() override;
@@ -39,7 +39,7 @@ class KulikovDiffCountNumberCharPerfTests : public ppc::util::BaseRunPerfTests<I
   }
 
   InType GetTestInputData() final {
-    return input_data;
+    return std::move(input_data);
   }
 };
 
@@ -26,8 +26,8 @@ bool LikhanovMElemVecSumMPI::PreProcessingImpl() {
 bool LikhanovMElemVecSumMPI::RunImpl() {
   int rank = 0;
   int size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   const int64_t n = GetInput();
 
@@ -44,7 +44,7 @@ bool LikhanovMElemVecSumMPI::RunImpl() {
   }
 
   int64_t global_sum = 0;
-  MPI_Reduce(&local_sum, &global_sum, 1, MPI_INT64_T, MPI_SUM, 0, MPI_COMM_WORLD);
+  MPI_Reduce(&local_sum, &global_sum, 1, MPI_INT64_T, MPI_SUM, 0, GetComm());
 
   if (rank == 0) {
     GetOutput() = global_sum;
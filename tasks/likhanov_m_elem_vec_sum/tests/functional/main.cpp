@@ -10,6 +10,7 @@
 #include "likhanov_m_elem_vec_sum/mpi/include/ops_mpi.hpp"
 #include "likhanov_m_elem_vec_sum/seq/include/ops_seq.hpp"
 #include "util/include/func_test_util.hpp"
+#include "util/include/task_comm.hpp"
 #include "util/include/util.hpp"
 
 namespace likhanov_m_elem_vec_sum {
@@ -36,7 +37,7 @@ class LikhanovMElemVecSumRunFuncTests : public ppc::util::BaseRunFuncTests<InTyp
 
     int rank = 0;
     if (mpi_initialized == 1) {
-      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      MPI_Comm_rank(ppc::util::GetTaskParentComm(), &rank);
       if (rank != 0) {
         return true;
       }
@@ -17,7 +17,7 @@ LikhanovMHypercubeMPI::LikhanovMHypercubeMPI(const InType &in) {
 
 bool LikhanovMHypercubeMPI::ValidationImpl() {
   int size = 0;
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_size(GetComm(), &size);
 
   return size > 0 && ((size & (size - 1)) == 0);
 }
@@ -31,8 +31,8 @@ bool LikhanovMHypercubeMPI::RunImpl() {
   int rank = 0;
   int size = 0;
 
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   if (!IsPowerOfTwo(size)) {
     return false;
@@ -63,17 +63,17 @@ bool LikhanovMHypercubeMPI::RunImpl() {
     int partner = rank ^ (1 << k);
 
     if ((rank & (1 << k)) != 0) {
-      MPI_Send(&sum, 1, MPI_UINT64_T, partner, 0, MPI_COMM_WORLD);
+      MPI_Send(&sum, 1, MPI_UINT64_T, partner, 0, GetComm());
       break;
     }
     if (partner < size) {
       std::uint64_t received = 0;
-      MPI_Recv(&received, 1, MPI_UINT64_T, partner, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      MPI_Recv(&received, 1, MPI_UINT64_T, partner, 0, GetComm(), MPI_STATUS_IGNORE);
       sum += received;
     }
   }
 
-  MPI_Bcast(&sum, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&sum, 1, MPI_UINT64_T, 0, GetComm());
 
   GetOutput() = static_cast<OutType>(sum);
 
@@ -8,6 +8,7 @@
 #include "likhanov_m_hypercube/common/include/common.hpp"
 #include "likhanov_m_hypercube/mpi/include/ops_mpi.hpp"
 #include "likhanov_m_hypercube/seq/include/ops_seq.hpp"
+#include "util/include/task_comm.hpp"
 
 namespace likhanov_m_hypercube {
 
@@ -59,7 +60,7 @@ TEST_P(LikhanovMHypercubeRunFuncTests, MpiMatchesSeq) {
   const InType n = std::get<0>(GetParam());
 
   int rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(ppc::util::GetTaskParentComm(), &rank);
 
   LikhanovMHypercubeMPI mpi_task(n);
   RunAndValidateTask(mpi_task);
@@ -26,12 +26,12 @@ MorozovaSBroadcastMPI::MorozovaSBroadcastMPI(const InType &in, int root) : root_
 
 bool MorozovaSBroadcastMPI::ValidationImpl() {
   int size = 0;
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_size(GetComm(), &size);
   if (root_ < 0 || root_ >= size) {
     return false;
   }
   int rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(GetComm(), &rank);
   if (rank == root_) {
     return !GetInput().empty();
   }
@@ -44,18 +44,18 @@ bool MorozovaSBroadcastMPI::PreProcessingImpl() {
 
 bool MorozovaSBroadcastMPI::RunImpl() {
   int rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(GetComm(), &rank);
   int data_size = 0;
   if (rank == root_) {
     data_size = static_cast<int>(GetInput().size());
   }
-  CustomBroadcast(&data_size, 1, MPI_INT, root_, MPI_COMM_WORLD);
+  CustomBroadcast(&data_size, 1, MPI_INT, root_, GetComm());
   GetOutput().resize(static_cast<size_t>(data_size));
   if (data_size > 0) {
     if (rank == root_) {
       std::copy(GetInput().begin(), GetInput().end(), GetOutput().begin());
     }
-    CustomBroadcast(GetOutput().data(), data_size, MPI_INT, root_, MPI_COMM_WORLD);
+    CustomBroadcast(GetOutput().data(), data_size, MPI_INT, root_, GetComm());
   }
   return true;
 }
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cstddef>
 #include <cstring>
+#include <vector>
 
 #include "morozova_s_broadcast/common/include/common.hpp"
 #include "morozova_s_broadcast/mpi/include/ops_mpi.hpp"
@@ -24,6 +26,14 @@ class MorozovaSRunPerfTestProcesses : public ppc::util::BaseRunPerfTests<InType,
   InType GetTestInputData() final {
     return input_data_;
   }
+
+  std::vector<std::size_t> GetTestInputSizes() final {
+    return ppc::performance::SizeLadder(kCount_, 4);
+  }
+
+  InType GetTestInputDataOfSize(std::size_t size) final {
+    return InType(size, 1);
+  }
 };
 
 TEST_P(MorozovaSRunPerfTestProcesses, RunPerfModes) {
@@ -2,13 +2,19 @@
 
 #include <string>
 #include <tuple>
-#include <vector>
 
 #include "task/include/task.hpp"
+#include "util/include/matrix.hpp"
 
 namespace morozova_s_connected_components {
-using InType = std::vector<std::vector<int>>;
-using OutType = std::vector<std::vector<int>>;
+/// @brief Component label of every pixel (0 for the background) and the number of components.
+struct Components {
+  ppc::util::Matrix<int> labels;
+  int count = 0;
+};
+
+using InType = ppc::util::Matrix<int>;
+using OutType = Components;
 using TestType = std::tuple<int, std::string>;
 using BaseTask = ppc::task::Task<InType, OutType>;
 }  // namespace morozova_s_connected_components
@@ -29,14 +29,11 @@ class MorozovaSConnectedComponentsMPI : public BaseTask {
   void InitMPI();
   [[nodiscard]] std::pair<int, int> ComputeRowRange() const;
   void ComputeLocalComponents(int start_row, int end_row, int base_label);
-  void GatherLocalResults();
+  void GatherLocalResults(int start_row, int end_row);
   void MergeBoundaries();
   bool TryProcessBoundaryCell(int proc, int j, int dj, std::unordered_map<int, int> &parent);
   static int FindRoot(std::unordered_map<int, int> &parent, int v);
   void NormalizeLabels();
-  void BroadcastResult();
-  void SendLocalResult(int start_row, int end_row);
-  void ReceiveFinalResult();
 
   int rank_{0};
   int size_{1};
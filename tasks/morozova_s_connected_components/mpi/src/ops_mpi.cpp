@@ -11,13 +11,12 @@
 #include <vector>
 
 #include "morozova_s_connected_components/common/include/common.hpp"
+#include "util/include/matrix.hpp"
 
 namespace morozova_s_connected_components {
 
 namespace {
 constexpr int kLabelOffset = 1000000;
-constexpr int kTagLocal = 0;
-constexpr int kTagFinal = 1;
 
 constexpr std::array<std::pair<int, int>, 8> kShifts = {
     {{-1, -1}, {-1, 0}, {-1, 1}, {0, -1}, {0, 1}, {1, -1}, {1, 0}, {1, 1}}};
@@ -31,46 +30,25 @@ MorozovaSConnectedComponentsMPI::MorozovaSConnectedComponentsMPI(const InType &i
 
 bool MorozovaSConnectedComponentsMPI::ValidationImpl() {
   const auto &input = GetInput();
-  if (input.empty()) {
-    return true;
-  }
-  const size_t cols = input.front().size();
-  for (const auto &row : input) {
-    if (row.size() != cols) {
+  for (std::size_t i = 0; i < input.Rows(); ++i) {
+    if (!std::ranges::all_of(input.Row(i), [](int v) { return v == 0 || v == 1; })) {
       return false;
     }
-    for (int v : row) {
-      if (v != 0 && v != 1) {
-        return false;
-      }
-    }
   }
   return true;
 }
 
 bool MorozovaSConnectedComponentsMPI::PreProcessingImpl() {
-  rows_ = static_cast<int>(GetInput().size());
-
-  if (rows_ == 0) {
-    cols_ = 0;
-    GetOutput().clear();
-    return true;
-  }
-
-  cols_ = static_cast<int>(GetInput().front().size());
-
-  auto &output = GetOutput();
-  output.resize(rows_);
-  for (int i = 0; i < rows_; ++i) {
-    output[i].assign(cols_, 0);
-  }
-
+  // The label blocks travel through MPI straight from the output matrix
+  rows_ = static_cast<int>(GetInput().Rows());
+  cols_ = static_cast<int>(GetInput().Cols());
+  GetOutput() = {.labels = ppc::util::Matrix<int>(GetInput().Rows(), GetInput().Cols(), 0), .count = 0};
   return true;
 }
 
 void MorozovaSConnectedComponentsMPI::InitMPI() {
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
-  MPI_Comm_size(MPI_COMM_WORLD, &size_);
+  MPI_Comm_rank(GetComm(), &rank_);
+  MPI_Comm_size(GetComm(), &size_);
   rows_per_proc_ = rows_ / size_;
   remainder_ = rows_ % size_;
 }
@@ -83,11 +61,10 @@ std::pair<int, int> MorozovaSConnectedComponentsMPI::ComputeRowRange() const {
 
 std::vector<std::pair<int, int>> MorozovaSConnectedComponentsMPI::GetNeighbors(int row, int col) {
   std::vector<std::pair<int, int>> neighbors;
-  const auto &input = GetInput();
   for (const auto &[dr, dc] : kShifts) {
     const int nr = row + dr;
     const int nc = col + dc;
-    if (nr >= 0 && nr < rows_ && nc >= 0 && nc < cols_ && input[nr][nc] == 1) {
+    if (nr >= 0 && nr < rows_ && nc >= 0 && nc < cols_ && GetInput()(nr, nc) == 1) {
       neighbors.emplace_back(nr, nc);
     }
   }
@@ -95,16 +72,16 @@ std::vector<std::pair<int, int>> MorozovaSConnectedComponentsMPI::GetNeighbors(i
 }
 
 void MorozovaSConnectedComponentsMPI::FloodFill(int row, int col, int label) {
-  auto &output = GetOutput();
+  auto &labels = GetOutput().labels;
   std::queue<std::pair<int, int>> q;
   q.emplace(row, col);
-  output[row][col] = label;
+  labels(row, col) = label;
   while (!q.empty()) {
     const auto [r, c] = q.front();
     q.pop();
     for (const auto &[nr, nc] : GetNeighbors(r, c)) {
-      if (output[nr][nc] == 0) {
-        output[nr][nc] = label;
+      if (labels(nr, nc) == 0) {
+        labels(nr, nc) = label;
         q.emplace(nr, nc);
       }
     }
@@ -112,12 +89,12 @@ void MorozovaSConnectedComponentsMPI::FloodFill(int row, int col, int label) {
 }
 
 void MorozovaSConnectedComponentsMPI::ComputeLocalComponents(int start_row, int end_row, int base_label) {
-  const auto &input = GetInput();
-  auto &output = GetOutput();
+  const auto &grid = GetInput();
+  const auto &labels = GetOutput().labels;
   int local_label = 1;
   for (int i = start_row; i < end_row; ++i) {
     for (int j = 0; j < cols_; ++j) {
-      if (input[i][j] == 1 && output[i][j] == 0) {
+      if (grid(i, j) == 1 && labels(i, j) == 0) {
         FloodFill(i, j, base_label + local_label);
         ++local_label;
       }
@@ -125,31 +102,28 @@ void MorozovaSConnectedComponentsMPI::ComputeLocalComponents(int start_row, int
   }
 }
 
-void MorozovaSConnectedComponentsMPI::GatherLocalResults() {
-  auto &output = GetOutput();
-  for (int proc = 1; proc < size_; ++proc) {
-    const int ps = (proc * rows_per_proc_) + std::min(proc, remainder_);
-    const int pe = ps + rows_per_proc_ + (proc < remainder_ ? 1 : 0);
-    const int pr = pe - ps;
-    std::vector<int> buf(static_cast<size_t>(pr) * static_cast<size_t>(cols_));
-    MPI_Status status;
-    MPI_Recv(buf.data(), static_cast<int>(buf.size()), MPI_INT, proc, kTagLocal, MPI_COMM_WORLD, &status);
-    int count = 0;
-    MPI_Get_count(&status, MPI_INT, &count);
-    if (static_cast<size_t>(count) != buf.size()) {
-      return;
-    }
-    for (int i = 0; i < pr; ++i) {
-      const ptrdiff_t offset = static_cast<ptrdiff_t>(i) * static_cast<ptrdiff_t>(cols_);
-      std::copy(buf.begin() + offset, buf.begin() + offset + cols_, output[ps + i].begin());
-    }
+void MorozovaSConnectedComponentsMPI::GatherLocalResults(int start_row, int end_row) {
+  std::vector<int> counts(static_cast<std::size_t>(size_));
+  std::vector<int> displs(static_cast<std::size_t>(size_));
+  for (int proc = 0; proc < size_; ++proc) {
+    displs[proc] = (proc * rows_per_proc_) + std::min(proc, remainder_);
+    counts[proc] = rows_per_proc_ + (proc < remainder_ ? 1 : 0);
+  }
+  // Counts and displacements are in rows; every rank's block lands in place in the root's label matrix
+  auto &labels = GetOutput().labels;
+  const ppc::util::MatrixRowType row_type(labels.View());
+  const int local_rows = end_row - start_row;
+  if (rank_ == 0) {
+    MPI_Gatherv(MPI_IN_PLACE, local_rows, row_type.Get(), labels.Data(), counts.data(), displs.data(),
+                row_type.Get(), 0, GetComm());
+  } else {
+    MPI_Gatherv(labels.Row(start_row).data(), local_rows, row_type.Get(), nullptr, counts.data(), displs.data(),
+                row_type.Get(), 0, GetComm());
   }
 }
 
 bool MorozovaSConnectedComponentsMPI::TryProcessBoundaryCell(int proc, int j, int dj,
                                                              std::unordered_map<int, int> &parent) {
-  const auto &input = GetInput();
-  const auto &output = GetOutput();
   const int br = (proc * rows_per_proc_) + std::min(proc, remainder_);
 
   if (br <= 0 || br >= rows_) {
@@ -161,12 +135,14 @@ bool MorozovaSConnectedComponentsMPI::TryProcessBoundaryCell(int proc, int j, in
     return false;
   }
 
-  if (input[br - 1][j] != 1 || input[br][nj] != 1) {
+  const auto &grid = GetInput();
+  if (grid(br - 1, j) != 1 || grid(br, nj) != 1) {
     return false;
   }
 
-  const int a = output[br - 1][j];
-  const int b = output[br][nj];
+  const auto &labels = GetOutput().labels;
+  const int a = labels(br - 1, j);
+  const int b = labels(br, nj);
 
   if (a == 0 || b == 0 || a == b) {
     return false;
@@ -205,7 +181,6 @@ int MorozovaSConnectedComponentsMPI::FindRoot(std::unordered_map<int, int> &pare
 }
 
 void MorozovaSConnectedComponentsMPI::MergeBoundaries() {
-  auto &output = GetOutput();
   std::unordered_map<int, int> parent;
   for (int proc = 1; proc < size_; ++proc) {
     const int br = (proc * rows_per_proc_) + std::min(proc, remainder_);
@@ -218,9 +193,10 @@ void MorozovaSConnectedComponentsMPI::MergeBoundaries() {
       TryProcessBoundaryCell(proc, j, 1, parent);
     }
   }
+  auto &labels = GetOutput().labels;
   for (int i = 0; i < rows_; ++i) {
     for (int j = 0; j < cols_; ++j) {
-      int &v = output[i][j];
+      int &v = labels(i, j);
       if (v > 0) {
         v = FindRoot(parent, v);
       }
@@ -229,11 +205,11 @@ void MorozovaSConnectedComponentsMPI::MergeBoundaries() {
 }
 
 void MorozovaSConnectedComponentsMPI::NormalizeLabels() {
-  auto &output = GetOutput();
+  auto &labels = GetOutput().labels;
   std::unordered_map<int, int> remap;
   int next = 1;
-  for (auto &row : output) {
-    for (int &v : row) {
+  for (std::size_t i = 0; i < labels.Rows(); ++i) {
+    for (int &v : labels.Row(i)) {
       if (v > 0) {
         auto it = remap.find(v);
         if (it == remap.end()) {
@@ -247,45 +223,6 @@ void MorozovaSConnectedComponentsMPI::NormalizeLabels() {
   }
 }
 
-void MorozovaSConnectedComponentsMPI::BroadcastResult() {
-  auto &output = GetOutput();
-  std::vector<int> flat(static_cast<size_t>(rows_) * static_cast<size_t>(cols_));
-  for (int i = 0; i < rows_; ++i) {
-    const ptrdiff_t offset = static_cast<ptrdiff_t>(i) * static_cast<ptrdiff_t>(cols_);
-    std::copy(output[i].begin(), output[i].end(), flat.begin() + offset);
-  }
-  for (int proc = 1; proc < size_; ++proc) {
-    MPI_Send(flat.data(), static_cast<int>(flat.size()), MPI_INT, proc, kTagFinal, MPI_COMM_WORLD);
-  }
-}
-
-void MorozovaSConnectedComponentsMPI::SendLocalResult(int start_row, int end_row) {
-  const auto &output = GetOutput();
-  const int lr = end_row - start_row;
-  std::vector<int> send(static_cast<size_t>(lr) * static_cast<size_t>(cols_));
-  for (int i = 0; i < lr; ++i) {
-    const ptrdiff_t offset = static_cast<ptrdiff_t>(i) * static_cast<ptrdiff_t>(cols_);
-    std::copy(output[start_row + i].begin(), output[start_row + i].end(), send.begin() + offset);
-  }
-  MPI_Send(send.data(), static_cast<int>(send.size()), MPI_INT, 0, kTagLocal, MPI_COMM_WORLD);
-}
-
-void MorozovaSConnectedComponentsMPI::ReceiveFinalResult() {
-  auto &output = GetOutput();
-  std::vector<int> recv(static_cast<size_t>(rows_) * static_cast<size_t>(cols_));
-  MPI_Status status;
-  MPI_Recv(recv.data(), static_cast<int>(recv.size()), MPI_INT, 0, kTagFinal, MPI_COMM_WORLD, &status);
-  int count = 0;
-  MPI_Get_count(&status, MPI_INT, &count);
-  if (static_cast<size_t>(count) != recv.size()) {
-    return;
-  }
-  for (int i = 0; i < rows_; ++i) {
-    const ptrdiff_t offset = static_cast<ptrdiff_t>(i) * static_cast<ptrdiff_t>(cols_);
-    std::copy(recv.begin() + offset, recv.begin() + offset + cols_, output[i].begin());
-  }
-}
-
 bool MorozovaSConnectedComponentsMPI::RunImpl() {
   InitMPI();
   if (rows_ == 0 || cols_ == 0) {
@@ -293,30 +230,23 @@ bool MorozovaSConnectedComponentsMPI::RunImpl() {
   }
   const auto [start, end] = ComputeRowRange();
   ComputeLocalComponents(start, end, rank_ * kLabelOffset);
+  GatherLocalResults(start, end);
   if (rank_ == 0) {
-    GatherLocalResults();
     MergeBoundaries();
     NormalizeLabels();
-    BroadcastResult();
-  } else {
-    SendLocalResult(start, end);
-    ReceiveFinalResult();
   }
+  ppc::util::BcastMatrix(GetOutput().labels.View(), 0, GetComm());
   return true;
 }
 
 bool MorozovaSConnectedComponentsMPI::PostProcessingImpl() {
   auto &output = GetOutput();
-  if (output.empty()) {
+  if (output.labels.Empty()) {
     return true;
   }
-  int max_label = 0;
-  for (const auto &row : output) {
-    for (int v : row) {
-      max_label = std::max(max_label, v);
-    }
+  for (std::size_t i = 0; i < output.labels.Rows(); ++i) {
+    output.count = std::max(output.count, std::ranges::max(output.labels.Row(i)));
   }
-  output.push_back({max_label});
   return true;
 }
 
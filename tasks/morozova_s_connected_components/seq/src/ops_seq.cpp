@@ -5,7 +5,6 @@
 #include <cstddef>
 #include <queue>
 #include <utility>
-#include <vector>
 
 #include "morozova_s_connected_components/common/include/common.hpp"
 
@@ -24,56 +23,42 @@ constexpr std::array<std::pair<int, int>, 8> kShifts = {
 
 bool MorozovaSConnectedComponentsSEQ::ValidationImpl() {
   const auto &input = GetInput();
-  if (input.empty()) {
+  if (input.Rows() == 0) {
     return true;
   }
-  const size_t cols = input.front().size();
-  if (cols == 0) {
+  if (input.Cols() == 0) {
     return false;
   }
-  for (const auto &row : input) {
-    if (row.size() != cols) {
+  for (std::size_t i = 0; i < input.Rows(); ++i) {
+    if (!std::ranges::all_of(input.Row(i), [](int val) { return val == 0 || val == 1; })) {
       return false;
     }
-    for (int val : row) {
-      if (val != 0 && val != 1) {
-        return false;
-      }
-    }
   }
   return true;
 }
 
 bool MorozovaSConnectedComponentsSEQ::PreProcessingImpl() {
   const auto &input = GetInput();
-  if (input.empty()) {
-    GetOutput().clear();
-    return true;
-  }
-  rows_ = static_cast<int>(input.size());
-  cols_ = static_cast<int>(input.front().size());
-  auto &output = GetOutput();
-  output.resize(rows_);
-  for (int i = 0; i < rows_; ++i) {
-    output[i].resize(cols_, 0);
-  }
+  rows_ = static_cast<int>(input.Rows());
+  cols_ = static_cast<int>(input.Cols());
+  GetOutput() = {.labels = ppc::util::Matrix<int>(input.Rows(), input.Cols(), 0), .count = 0};
   return true;
 }
 
 void MorozovaSConnectedComponentsSEQ::ProcessComponent(int start_i, int start_j, int current_label) {
   const auto &input = GetInput();
-  auto &output = GetOutput();
+  auto &output = GetOutput().labels;
   std::queue<std::pair<int, int>> q;
   q.emplace(start_i, start_j);
-  output[start_i][start_j] = current_label;
+  output(start_i, start_j) = current_label;
   while (!q.empty()) {
     const auto [x, y] = q.front();
     q.pop();
     for (const auto &[dx, dy] : kShifts) {
       const int nx = x + dx;
       const int ny = y + dy;
-      if (nx >= 0 && nx < rows_ && ny >= 0 && ny < cols_ && input[nx][ny] == 1 && output[nx][ny] == 0) {
-        output[nx][ny] = current_label;
+      if (nx >= 0 && nx < rows_ && ny >= 0 && ny < cols_ && input(nx, ny) == 1 && output(nx, ny) == 0) {
+        output(nx, ny) = current_label;
         q.emplace(nx, ny);
       }
     }
@@ -82,14 +67,14 @@ void MorozovaSConnectedComponentsSEQ::ProcessComponent(int start_i, int start_j,
 
 bool MorozovaSConnectedComponentsSEQ::RunImpl() {
   const auto &input = GetInput();
-  auto &output = GetOutput();
-  if (input.empty() || rows_ == 0 || cols_ == 0) {
+  const auto &output = GetOutput().labels;
+  if (rows_ == 0 || cols_ == 0) {
     return true;
   }
   int current_label = 1;
   for (int i = 0; i < rows_; ++i) {
     for (int j = 0; j < cols_; ++j) {
-      if (input[i][j] == 1 && output[i][j] == 0) {
+      if (input(i, j) == 1 && output(i, j) == 0) {
         ProcessComponent(i, j, current_label);
         ++current_label;
       }
@@ -101,16 +86,12 @@ bool MorozovaSConnectedComponentsSEQ::RunImpl() {
 
 bool MorozovaSConnectedComponentsSEQ::PostProcessingImpl() {
   auto &output = GetOutput();
-  if (output.empty()) {
+  if (output.labels.Empty()) {
     return true;
   }
-  int max_label = 0;
-  for (const auto &row : output) {
-    for (const int v : row) {
-      max_label = std::max(max_label, v);
-    }
+  for (std::size_t i = 0; i < output.labels.Rows(); ++i) {
+    output.count = std::max(output.count, std::ranges::max(output.labels.Row(i)));
   }
-  output.push_back({max_label});
   return true;
 }
 
@@ -27,39 +27,39 @@ class MorozovaSRunFuncTestsConnectedComponents : public ppc::util::BaseRunFuncTe
     int size = std::get<0>(test_params);
     std::string pattern = std::get<1>(test_params);
     if (size <= 0) {
-      input_data_ = {};
+      input_data_ = InType();
       return;
     }
-    input_data_ = std::vector<std::vector<int>>(size, std::vector<int>(size, 0));
+    input_data_ = InType(size, size, 0);
     if (pattern == "cross") {
       for (int i = 0; i < size; ++i) {
-        input_data_[i][size / 2] = 1;
-        input_data_[size / 2][i] = 1;
+        input_data_(i, size / 2) = 1;
+        input_data_(size / 2, i) = 1;
       }
     } else if (pattern == "square") {
       for (int i = size / 4; i < 3 * size / 4; ++i) {
         for (int j = size / 4; j < 3 * size / 4; ++j) {
-          input_data_[i][j] = 1;
+          input_data_(i, j) = 1;
         }
       }
     } else if (pattern == "dots") {
       for (int i = 1; i < size; i += 2) {
         for (int j = 1; j < size; j += 2) {
-          input_data_[i][j] = 1;
+          input_data_(i, j) = 1;
         }
       }
     } else if (pattern == "border") {
       for (int i = 0; i < size; ++i) {
-        input_data_[0][i] = 1;
-        input_data_[size - 1][i] = 1;
-        input_data_[i][0] = 1;
-        input_data_[i][size - 1] = 1;
+        input_data_(0, i) = 1;
+        input_data_(size - 1, i) = 1;
+        input_data_(i, 0) = 1;
+        input_data_(i, size - 1) = 1;
       }
     } else {
       for (int i = 0; i < size; ++i) {
         for (int j = 0; j < size; ++j) {
           if ((i + j) % 2 == 0) {
-            input_data_[i][j] = 1;
+            input_data_(i, j) = 1;
           }
         }
       }
@@ -67,63 +67,34 @@ class MorozovaSRunFuncTestsConnectedComponents : public ppc::util::BaseRunFuncTe
   }
 
   bool CheckTestOutputData(OutType &output_data) final {
-    if (output_data.empty()) {
-      return true;
-    }
-    int reported_components = 0;
-    if (!output_data.empty() && output_data.back().size() == 1) {
-      reported_components = output_data.back()[0];
-      output_data.pop_back();
-    }
-    if (output_data.size() != input_data_.size()) {
+    const auto &labels = output_data.labels;
+    if (labels.Rows() != input_data_.Rows() || labels.Cols() != input_data_.Cols()) {
       return false;
     }
-    for (std::size_t i = 0; i < input_data_.size(); ++i) {
-      if (output_data[i].size() != input_data_[i].size()) {
-        return false;
-      }
-      for (std::size_t j = 0; j < input_data_[i].size(); ++j) {
-        if (input_data_[i][j] == 1) {
-          if (output_data[i][j] <= 0) {
+    std::vector<int> found;
+    for (std::size_t i = 0; i < input_data_.Rows(); ++i) {
+      for (std::size_t j = 0; j < input_data_.Cols(); ++j) {
+        if (input_data_(i, j) == 1) {
+          if (labels(i, j) <= 0) {
             return false;
           }
-        } else {
-          if (output_data[i][j] != 0) {
-            return false;
-          }
-        }
-      }
-    }
-
-    std::vector<int> labels;
-    for (const auto &row : output_data) {
-      for (int label : row) {
-        if (label > 0) {
-          labels.push_back(label);
+          found.push_back(labels(i, j));
+        } else if (labels(i, j) != 0) {
+          return false;
         }
       }
     }
-    std::ranges::sort(labels);
-    const auto [first, last] = std::ranges::unique(labels);
-    labels.erase(first, last);
+    std::ranges::sort(found);
+    const auto [first, last] = std::ranges::unique(found);
+    found.erase(first, last);
 
-    if (!labels.empty()) {
-      if (labels[0] != 1) {
+    // Labels are numbered 1..count without gaps
+    for (std::size_t i = 0; i < found.size(); ++i) {
+      if (found[i] != static_cast<int>(i) + 1) {
         return false;
       }
-      for (std::size_t i = 1; i < labels.size(); ++i) {
-        if (labels[i] != labels[i - 1] + 1) {
-          return false;
-        }
-      }
-      if (labels.size() != static_cast<std::size_t>(reported_components)) {
-        return false;
-      }
-    } else if (reported_components != 0) {
-      return false;
     }
-
-    return true;
+    return found.size() == static_cast<std::size_t>(output_data.count);
   }
 
   InType GetTestInputData() final {
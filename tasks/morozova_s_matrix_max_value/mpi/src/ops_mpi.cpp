@@ -3,10 +3,12 @@
 #include <mpi.h>
 
 #include <algorithm>
-#include <cstddef>
+#include <limits>
+#include <span>
 #include <vector>
 
 #include "morozova_s_matrix_max_value/common/include/common.hpp"
+#include "util/include/mpi_collectives.hpp"
 
 namespace morozova_s_matrix_max_value {
 
@@ -17,15 +19,8 @@ MorozovaSMatrixMaxValueMPI::MorozovaSMatrixMaxValueMPI(const InType &in) : BaseT
 }
 
 bool MorozovaSMatrixMaxValueMPI::ValidationImpl() {
-  const auto &matrix = GetInput();
-  if (matrix.empty()) {
-    return true;
-  }
-  if (matrix[0].empty()) {
-    return true;
-  }
-  const size_t cols = matrix[0].size();
-  return std::ranges::all_of(matrix, [cols](const auto &row) { return row.size() == cols; });
+  // The elements are scattered straight from the matrix storage, so the rows must be packed
+  return GetInput().View().IsContiguous();
 }
 
 bool MorozovaSMatrixMaxValueMPI::PreProcessingImpl() {
@@ -35,42 +30,21 @@ bool MorozovaSMatrixMaxValueMPI::PreProcessingImpl() {
 bool MorozovaSMatrixMaxValueMPI::RunImpl() {
   int rank = 0;
   int size = 1;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
   const auto &matrix = GetInput();
-  if (matrix.empty() || matrix[0].empty()) {
+  if (matrix.Empty()) {
     GetOutput() = 0;
     return true;
   }
-  const int rows = static_cast<int>(matrix.size());
-  const int cols = static_cast<int>(matrix[0].size());
-  const int total = rows * cols;
-  std::vector<int> flat;
-  if (rank == 0) {
-    flat.reserve(total);
-    for (const auto &row : matrix) {
-      flat.insert(flat.end(), row.begin(), row.end());
-    }
-  }
-  std::vector<int> counts(size);
-  std::vector<int> displs(size);
-  const int base = total / size;
-  const int rest = total % size;
-  for (int i = 0, off = 0; i < size; ++i) {
-    counts[i] = base + static_cast<int>(i < rest);
-    displs[i] = off;
-    off += counts[i];
-  }
-  std::vector<int> local(counts[rank]);
-  MPI_Scatterv(rank == 0 ? flat.data() : nullptr, counts.data(), displs.data(), MPI_INT, local.data(), counts[rank],
-               MPI_INT, 0, MPI_COMM_WORLD);
+  const ppc::util::mpi::BlockPartition partition(matrix.Rows() * matrix.Cols(), size);
+  const std::span<const int> elements(matrix.Data(), rank == 0 ? partition.Total() : 0);
+  const std::vector<int> local = ppc::util::mpi::ScatterBalanced(elements, partition, 0, GetComm());
 
-  int local_max = local[0];
-  for (int v : local) {
-    local_max = std::max(local_max, v);
-  }
+  // Ranks without elements take part in the reduction with the neutral value
+  const int local_max = local.empty() ? std::numeric_limits<int>::min() : std::ranges::max(local);
   int global_max = 0;
-  MPI_Allreduce(&local_max, &global_max, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(&local_max, &global_max, 1, MPI_INT, MPI_MAX, GetComm());
   GetOutput() = global_max;
   return true;
 }
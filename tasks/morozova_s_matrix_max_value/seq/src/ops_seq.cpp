@@ -2,7 +2,6 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <vector>
 
 #include "morozova_s_matrix_max_value/common/include/common.hpp"
 
@@ -14,15 +13,6 @@ MorozovaSMatrixMaxValueSEQ::MorozovaSMatrixMaxValueSEQ(const InType &in) : BaseT
 }
 
 bool MorozovaSMatrixMaxValueSEQ::ValidationImpl() {
-  const auto &matrix = GetInput();
-  if (matrix.empty() || matrix[0].empty()) {
-    return true;
-  }
-  const size_t cols = matrix[0].size();
-  bool all_equal = std::ranges::all_of(matrix, [cols](const auto &row) { return row.size() == cols; });
-  if (!all_equal) {
-    return true;
-  }
   return true;
 }
 
@@ -32,20 +22,13 @@ bool MorozovaSMatrixMaxValueSEQ::PreProcessingImpl() {
 
 bool MorozovaSMatrixMaxValueSEQ::RunImpl() {
   const auto &matrix = GetInput();
-  if (matrix.empty() || matrix[0].empty()) {
-    GetOutput() = 0;
-    return true;
-  }
-  const size_t cols = matrix[0].size();
-  if (!std::ranges::all_of(matrix, [cols](const auto &row) { return row.size() == cols; })) {
+  if (matrix.Empty()) {
     GetOutput() = 0;
     return true;
   }
-  int max_value = matrix[0][0];
-  for (const auto &row : matrix) {
-    for (int value : row) {
-      max_value = std::max(max_value, value);
-    }
+  int max_value = matrix(0, 0);
+  for (std::size_t row = 0; row < matrix.Rows(); row++) {
+    max_value = std::max(max_value, std::ranges::max(matrix.Row(row)));
   }
   GetOutput() = max_value;
   return true;
@@ -27,29 +27,26 @@ class MorozovaSRunFuncTestsProcesses : public ppc::util::BaseRunFuncTests<InType
     int test_number = std::get<0>(params);
     switch (test_number) {
       case 1:
-        input_data_ = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+        input_data_ = InType::FromRows({{1, 2, 3}, {4, 5, 6}, {7, 8, 9}});
         break;
       case 2:
-        input_data_ = {{10, 20, 30, 40}, {15, 25, 35, 45}, {12, 22, 32, 42}, {18, 28, 38, 48}};
+        input_data_ = InType::FromRows({{10, 20, 30, 40}, {15, 25, 35, 45}, {12, 22, 32, 42}, {18, 28, 38, 48}});
         break;
       case 3:
-        input_data_ = {{100, 200, 300, 400, 500},
-                       {150, 250, 350, 450, 550},
-                       {120, 220, 320, 420, 520},
-                       {180, 280, 380, 480, 580},
-                       {160, 260, 360, 460, 1000}};
+        input_data_ = InType::FromRows({{100, 200, 300, 400, 500},
+                                        {150, 250, 350, 450, 550},
+                                        {120, 220, 320, 420, 520},
+                                        {180, 280, 380, 480, 580},
+                                        {160, 260, 360, 460, 1000}});
         break;
       case 4:
-        input_data_ = {};
-        break;
-      case 5:
-        input_data_ = {{1, 2, 3}, {4, 5}};
+        input_data_ = InType();
         break;
       case 6:
-        input_data_ = {{}};
+        input_data_ = InType(1, 0);
         break;
       default:
-        input_data_ = {{1, 2}, {3, 4}};
+        input_data_ = InType::FromRows({{1, 2}, {3, 4}});
         break;
     }
   }
@@ -57,12 +54,12 @@ class MorozovaSRunFuncTestsProcesses : public ppc::util::BaseRunFuncTests<InType
   bool CheckTestOutputData(OutType &output_data) final {
     TestType params = std::get<static_cast<std::size_t>(ppc::util::GTestParamIndex::kTestParams)>(GetParam());
     int test_number = std::get<0>(params);
-    if (test_number == 4 || test_number == 5 || test_number == 6) {
+    if (test_number == 4 || test_number == 6) {
       return true;
     }
     int expected_max = std::numeric_limits<int>::min();
-    for (const auto &row : input_data_) {
-      for (int value : row) {
+    for (std::size_t row = 0; row < input_data_.Rows(); row++) {
+      for (int value : input_data_.Row(row)) {
         expected_max = std::max(expected_max, value);
       }
     }
@@ -83,9 +80,9 @@ TEST_P(MorozovaSRunFuncTestsProcesses, MatrixMaxValue) {
 const std::array<TestType, 3> kTestParamMPI = {std::make_tuple(1, "small"), std::make_tuple(2, "medium"),
                                                std::make_tuple(3, "large")};
 
-const std::array<TestType, 6> kTestParamSEQ = {std::make_tuple(1, "small"),   std::make_tuple(2, "medium"),
-                                               std::make_tuple(3, "large"),   std::make_tuple(4, "empty"),
-                                               std::make_tuple(5, "invalid"), std::make_tuple(6, "zero_cols")};
+const std::array<TestType, 5> kTestParamSEQ = {std::make_tuple(1, "small"), std::make_tuple(2, "medium"),
+                                               std::make_tuple(3, "large"), std::make_tuple(4, "empty"),
+                                               std::make_tuple(6, "zero_cols")};
 const auto kTestTasksMPI =
     ppc::util::AddFuncTask<MorozovaSMatrixMaxValueMPI, InType>(kTestParamMPI, PPC_SETTINGS_morozova_s_matrix_max_value);
 const auto kTestTasksSEQ =
@@ -1,6 +1,6 @@
 #include <gtest/gtest.h>
 
-#include <vector>
+#include <cstddef>
 
 #include "morozova_s_matrix_max_value/common/include/common.hpp"
 #include "morozova_s_matrix_max_value/mpi/include/ops_mpi.hpp"
@@ -13,12 +13,12 @@ class MorozovaSMatrixMaxValuePerfTests : public ppc::util::BaseRunPerfTests<InTy
   InType input_data_;
 
   void SetUp() override {
-    const int size = 5000;
-    input_data_ = InType(size, std::vector<int>(size));
+    const std::size_t size = 5000;
+    input_data_ = InType(size, size);
     int value = 1;
-    for (int i = 0; i < size; ++i) {
-      for (int j = 0; j < size; ++j) {
-        input_data_[i][j] = value++;
+    for (std::size_t i = 0; i < size; ++i) {
+      for (std::size_t j = 0; j < size; ++j) {
+        input_data_(i, j) = value++;
       }
     }
   }
@@ -21,8 +21,8 @@ class SabutayAIncreaseContrastMPI : public BaseTask {
   bool PostProcessingImpl() override;
 
   std::vector<unsigned char> ScatterInputData(int rank, int size, int data_len);
-  static void FindGlobalMinMax(const std::vector<unsigned char> &proc_part, unsigned char *data_min,
-                               unsigned char *data_max);
+  void FindGlobalMinMax(const std::vector<unsigned char> &proc_part, unsigned char *data_min,
+                        unsigned char *data_max);
   static std::vector<unsigned char> ApplyContrast(const std::vector<unsigned char> &proc_part, unsigned char data_min,
                                                   unsigned char data_max);
 };
@@ -27,8 +27,8 @@ bool SabutayAIncreaseContrastMPI::PreProcessingImpl() {
 bool SabutayAIncreaseContrastMPI::RunImpl() {
   int rank = 0;
   int size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   int data_len = 0;
   if (rank == 0) {
@@ -36,7 +36,7 @@ bool SabutayAIncreaseContrastMPI::RunImpl() {
   }
 
   // Рассылаем процессам размер данных
-  MPI_Bcast(&data_len, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&data_len, 1, MPI_INT, 0, GetComm());
 
   // Раздаем локальные данные всем процессам
   std::vector<unsigned char> proc_part = ScatterInputData(rank, size, data_len);
@@ -64,7 +64,7 @@ bool SabutayAIncreaseContrastMPI::RunImpl() {
   // Рассылаем результат всем процессам
   GetOutput().resize(data_len);
   MPI_Allgatherv(local_output.data(), static_cast<int>(local_output.size()), MPI_UNSIGNED_CHAR, GetOutput().data(),
-                 counts.data(), step.data(), MPI_UNSIGNED_CHAR, MPI_COMM_WORLD);
+                 counts.data(), step.data(), MPI_UNSIGNED_CHAR, GetComm());
 
   return true;
 }
@@ -86,10 +86,10 @@ std::vector<unsigned char> SabutayAIncreaseContrastMPI::ScatterInputData(int ran
   std::vector<unsigned char> proc_part(my_size);
   if (rank == 0) {
     MPI_Scatterv(GetInput().data(), counts.data(), step.data(), MPI_UNSIGNED_CHAR, proc_part.data(), my_size,
-                 MPI_UNSIGNED_CHAR, 0, MPI_COMM_WORLD);
+                 MPI_UNSIGNED_CHAR, 0, GetComm());
   } else {
     MPI_Scatterv(nullptr, nullptr, nullptr, MPI_UNSIGNED_CHAR, proc_part.data(), my_size, MPI_UNSIGNED_CHAR, 0,
-                 MPI_COMM_WORLD);
+                 GetComm());
   }
   return proc_part;
 }
@@ -103,8 +103,8 @@ void SabutayAIncreaseContrastMPI::FindGlobalMinMax(const std::vector<unsigned ch
     local_max = std::max(local_max, pixel);
   }
 
-  MPI_Allreduce(&local_min, data_min, 1, MPI_UNSIGNED_CHAR, MPI_MIN, MPI_COMM_WORLD);
-  MPI_Allreduce(&local_max, data_max, 1, MPI_UNSIGNED_CHAR, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(&local_min, data_min, 1, MPI_UNSIGNED_CHAR, MPI_MIN, GetComm());
+  MPI_Allreduce(&local_max, data_max, 1, MPI_UNSIGNED_CHAR, MPI_MAX, GetComm());
 }
 
 std::vector<unsigned char> SabutayAIncreaseContrastMPI::ApplyContrast(const std::vector<unsigned char> &proc_part,
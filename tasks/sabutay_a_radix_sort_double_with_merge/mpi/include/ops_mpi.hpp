@@ -24,8 +24,11 @@ class SabutayAradixSortDoubleWithMergeMPI : public BaseTask {
   bool PreProcessingImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
+  void SnapshotRunStateImpl() override;
+  void RestoreRunStateImpl() override;
 
   std::vector<double> local_;
+  std::vector<double> local_snapshot_;
   std::vector<int> counts_;
   std::vector<int> displs_;
   int world_rank_{0};
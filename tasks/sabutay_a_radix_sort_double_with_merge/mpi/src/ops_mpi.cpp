@@ -117,20 +117,20 @@ void SendVectorD(int dst, int tag_base, const std::vector<double> &v, MPI_Comm c
 }  // namespace
 
 bool SabutayAradixSortDoubleWithMergeMPI::ValidationImpl() {
-  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank_);
-  MPI_Comm_size(MPI_COMM_WORLD, &world_size_);
+  MPI_Comm_rank(GetComm(), &world_rank_);
+  MPI_Comm_size(GetComm(), &world_size_);
   return true;
 }
 
 bool SabutayAradixSortDoubleWithMergeMPI::PreProcessingImpl() {
-  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank_);
-  MPI_Comm_size(MPI_COMM_WORLD, &world_size_);
+  MPI_Comm_rank(GetComm(), &world_rank_);
+  MPI_Comm_size(GetComm(), &world_size_);
 
   int global_size = 0;
   if (world_rank_ == 0) {
     global_size = static_cast<int>(GetInput().size());
   }
-  MPI_Bcast(&global_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&global_size, 1, MPI_INT, 0, GetComm());
 
   counts_.assign(world_size_, 0);
   displs_.assign(world_size_, 0);
@@ -153,7 +153,7 @@ bool SabutayAradixSortDoubleWithMergeMPI::PreProcessingImpl() {
   }
 
   MPI_Scatterv(send_buf, counts_.data(), displs_.data(), MPI_DOUBLE, local_.data(), counts_[world_rank_], MPI_DOUBLE, 0,
-               MPI_COMM_WORLD);
+               GetComm());
 
   GetOutput().clear();
   return true;
@@ -166,12 +166,12 @@ bool SabutayAradixSortDoubleWithMergeMPI::RunImpl() {
     if ((world_rank_ % (2 * step)) == 0) {
       const int partner = world_rank_ + step;
       if (partner < world_size_) {
-        std::vector<double> other = RecvVectorD(partner, 2000 + step, MPI_COMM_WORLD);
+        std::vector<double> other = RecvVectorD(partner, 2000 + step, GetComm());
         local_ = MergeSorted(local_, other);
       }
     } else {
       const int partner = world_rank_ - step;
-      SendVectorD(partner, 2000 + step, local_, MPI_COMM_WORLD);
+      SendVectorD(partner, 2000 + step, local_, GetComm());
       break;
     }
   }
@@ -185,16 +185,24 @@ bool SabutayAradixSortDoubleWithMergeMPI::PostProcessingImpl() {
     out_size = static_cast<int>(GetOutput().size());
   }
 
-  MPI_Bcast(&out_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&out_size, 1, MPI_INT, 0, GetComm());
 
   if (world_rank_ != 0) {
     GetOutput().assign(static_cast<std::size_t>(out_size), 0.0);
   }
 
   if (out_size > 0) {
-    MPI_Bcast(GetOutput().data(), out_size, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    MPI_Bcast(GetOutput().data(), out_size, MPI_DOUBLE, 0, GetComm());
   }
   return true;
 }
 
+void SabutayAradixSortDoubleWithMergeMPI::SnapshotRunStateImpl() {
+  local_snapshot_ = local_;
+}
+
+void SabutayAradixSortDoubleWithMergeMPI::RestoreRunStateImpl() {
+  local_ = local_snapshot_;
+}
+
 }  // namespace sabutay_a_radix_sort_double_with_merge
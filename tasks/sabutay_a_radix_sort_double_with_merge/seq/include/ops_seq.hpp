@@ -18,8 +18,11 @@ class SabutayAradixSortDoubleWithMergeSEQ : public BaseTask {
   bool PreProcessingImpl() override;
   bool RunImpl() override;
   bool PostProcessingImpl() override;
+  void SnapshotRunStateImpl() override;
+  void RestoreRunStateImpl() override;
 
   InType data_;
+  InType data_snapshot_;
 };
 
 }  // namespace sabutay_a_radix_sort_double_with_merge
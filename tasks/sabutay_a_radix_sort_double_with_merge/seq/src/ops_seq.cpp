@@ -97,4 +97,12 @@ bool SabutayAradixSortDoubleWithMergeSEQ::PostProcessingImpl() {
   return true;
 }
 
+void SabutayAradixSortDoubleWithMergeSEQ::SnapshotRunStateImpl() {
+  data_snapshot_ = data_;
+}
+
+void SabutayAradixSortDoubleWithMergeSEQ::RestoreRunStateImpl() {
+  data_ = data_snapshot_;
+}
+
 }  // namespace sabutay_a_radix_sort_double_with_merge
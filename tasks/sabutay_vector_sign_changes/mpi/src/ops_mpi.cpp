@@ -117,8 +117,8 @@ bool SabutayVectorSignChangesMPI::PreProcessingImpl() {
 bool SabutayVectorSignChangesMPI::RunImpl() {
   int rank = 0;
   int size = 1;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
   const InType n = GetInput();
   if (n <= 0) {
@@ -143,13 +143,13 @@ bool SabutayVectorSignChangesMPI::RunImpl() {
     all_info.resize(static_cast<std::size_t>(size) * 3);
   }
 
-  MPI_Gather(local_info.data(), 3, MPI_INT, rank == 0 ? all_info.data() : nullptr, 3, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Gather(local_info.data(), 3, MPI_INT, rank == 0 ? all_info.data() : nullptr, 3, MPI_INT, 0, GetComm());
 
   if (rank == 0) {
     GetOutput() = CombineGlobal(all_info);
   }
 
-  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Barrier(GetComm());
   return true;
 }
 
@@ -10,6 +10,7 @@
 #include "sabutay_vector_sign_changes/mpi/include/ops_mpi.hpp"
 #include "sabutay_vector_sign_changes/seq/include/ops_seq.hpp"
 #include "util/include/func_test_util.hpp"
+#include "util/include/task_comm.hpp"
 
 namespace sabutay_vector_sign_changes {
 
@@ -75,7 +76,7 @@ class SabutayKRunFuncTestsProcesses : public ppc::util::BaseRunFuncTests<InType,
     int initialized = 0;
     MPI_Initialized(&initialized);
     if (initialized != 0) {
-      MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+      MPI_Comm_rank(ppc::util::GetTaskParentComm(), &rank);
     }
 
     if (rank != 0) {
@@ -6,40 +6,18 @@
 #include <climits>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <vector>
 
 #include "shkryleva_s_vec_min_val/common/include/common.hpp"
+#include "util/include/mpi_collectives.hpp"
 
 namespace shkryleva_s_vec_min_val {
 
 namespace {
 
-struct DistributionInfo {
-  std::vector<int> sendcounts;
-  std::vector<int> displacements;
-  int local_count = 0;
-};
-
-DistributionInfo CalculateDistribution(int total_size, int world_size) {
-  DistributionInfo info;
-  info.sendcounts.resize(world_size);
-  info.displacements.resize(world_size);
-
-  const int base_size = total_size / world_size;
-  const int extra_items = total_size % world_size;
-
-  int offset = 0;
-  for (int i = 0; i < world_size; ++i) {
-    info.sendcounts[i] = base_size + (i < extra_items ? 1 : 0);
-    info.displacements[i] = offset;
-    offset += info.sendcounts[i];
-  }
-
-  return info;
-}
-
-void BroadcastVectorSize(uint64_t &total_size_uint64) {
-  MPI_Bcast(&total_size_uint64, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+void BroadcastVectorSize(uint64_t &total_size_uint64, MPI_Comm comm) {
+  MPI_Bcast(&total_size_uint64, 1, MPI_UINT64_T, 0, comm);
 }
 
 int ComputeLocalMinimum(const std::vector<int> &local_data) {
@@ -54,23 +32,9 @@ int ComputeLocalMinimum(const std::vector<int> &local_data) {
   return local_min;
 }
 
-std::vector<int> ScatterVectorData(const std::vector<int> *input_data_ptr, const DistributionInfo &info,
-                                   int world_rank) {
-  std::vector<int> local_data;
-
-  if (info.local_count > 0) {
-    local_data.resize(info.local_count);
-
-    MPI_Scatterv((world_rank == 0) ? input_data_ptr->data() : nullptr, info.sendcounts.data(),
-                 info.displacements.data(), MPI_INT, local_data.data(), info.local_count, MPI_INT, 0, MPI_COMM_WORLD);
-  }
-
-  return local_data;
-}
-
-int PerformGlobalReduction(int local_min) {
+int PerformGlobalReduction(int local_min, MPI_Comm comm) {
   int total_min = INT_MAX;
-  MPI_Allreduce(&local_min, &total_min, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(&local_min, &total_min, 1, MPI_INT, MPI_MIN, comm);
   return total_min;
 }
 
@@ -84,7 +48,7 @@ ShkrylevaSVecMinValMPI::ShkrylevaSVecMinValMPI(const InType &in) {
 
 bool ShkrylevaSVecMinValMPI::ValidationImpl() {
   int world_rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+  MPI_Comm_rank(GetComm(), &world_rank);
 
   bool is_valid = true;
 
@@ -96,7 +60,7 @@ bool ShkrylevaSVecMinValMPI::ValidationImpl() {
   }
 
   int validation_result = is_valid ? 1 : 0;
-  MPI_Bcast(&validation_result, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&validation_result, 1, MPI_INT, 0, GetComm());
 
   return validation_result != 0;
 }
@@ -109,32 +73,30 @@ bool ShkrylevaSVecMinValMPI::PreProcessingImpl() {
 bool ShkrylevaSVecMinValMPI::RunImpl() {
   int world_rank = 0;
   int world_size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+  MPI_Comm_rank(GetComm(), &world_rank);
+  MPI_Comm_size(GetComm(), &world_size);
 
   uint64_t total_size_uint64 = 0;
-  const std::vector<int> *input_data_ptr = nullptr;
+  std::span<const int> input_data;
 
   if (world_rank == 0) {
-    input_data_ptr = &GetInput();
-    total_size_uint64 = static_cast<uint64_t>(input_data_ptr->size());
+    input_data = GetInput();
+    total_size_uint64 = static_cast<uint64_t>(input_data.size());
   }
 
-  BroadcastVectorSize(total_size_uint64);
+  BroadcastVectorSize(total_size_uint64, GetComm());
 
-  const int total_size = static_cast<int>(total_size_uint64);
   int local_min = INT_MAX;
 
-  if (total_size > 0) {
-    DistributionInfo info = CalculateDistribution(total_size, world_size);
-    info.local_count = info.sendcounts[world_rank];
-
-    std::vector<int> local_data = ScatterVectorData(input_data_ptr, info, world_rank);
+  if (total_size_uint64 > 0) {
+    // Every rank takes part in the scatter, including the ones that receive no elements
+    const ppc::util::mpi::BlockPartition partition(total_size_uint64, world_size);
+    const std::vector<int> local_data = ppc::util::mpi::ScatterBalanced(input_data, partition, 0, GetComm());
 
     local_min = ComputeLocalMinimum(local_data);
   }
 
-  int total_min = PerformGlobalReduction(local_min);
+  int total_min = PerformGlobalReduction(local_min, GetComm());
 
   GetOutput() = total_min;
   return true;
@@ -75,13 +75,14 @@ void InitPayloadIfSource(const int world_rank, const int source_rank, const int
   *has_payload = true;
 }
 
-[[nodiscard]] bool RouteOneDimension(const int world_rank, const int destination_rank, const int dim_index,
-                                     std::vector<std::int32_t> *payload_buffer, bool *has_payload) {
+[[nodiscard]] bool RouteOneDimension(MPI_Comm comm, const int world_rank, const int destination_rank,
+                                     const int dim_index, std::vector<std::int32_t> *payload_buffer,
+                                     bool *has_payload) {
   const int bit_mask = (1 << dim_index);
   const int color_value = world_rank & ~bit_mask;
 
   MPI_Comm dim_comm = MPI_COMM_NULL;
-  MPI_Comm_split(MPI_COMM_WORLD, color_value, world_rank, &dim_comm);
+  MPI_Comm_split(comm, color_value, world_rank, &dim_comm);
 
   int dim_rank = 0;
   int dim_size = 0;
@@ -125,18 +126,18 @@ void InitPayloadIfSource(const int world_rank, const int source_rank, const int
   return true;
 }
 
-[[nodiscard]] int FinalizeRoutedSize(const int world_rank, const int destination_rank, const bool has_payload,
-                                     const std::vector<std::int32_t> &payload_buffer) {
+[[nodiscard]] int FinalizeRoutedSize(MPI_Comm comm, const int world_rank, const int destination_rank,
+                                     const bool has_payload, const std::vector<std::int32_t> &payload_buffer) {
   int routed_size = 0;
   if (world_rank == destination_rank) {
     routed_size = has_payload ? static_cast<int>(payload_buffer.size()) : 0;
   }
-  MPI_Bcast(&routed_size, 1, MPI_INT, destination_rank, MPI_COMM_WORLD);
+  MPI_Bcast(&routed_size, 1, MPI_INT, destination_rank, comm);
   return routed_size;
 }
 
-[[nodiscard]] int RouteHypercubeAndGetSize(const int world_rank, const int world_size, const int source_rank,
-                                           const int destination_rank, const int data_size) {
+[[nodiscard]] int RouteHypercubeAndGetSize(MPI_Comm comm, const int world_rank, const int world_size,
+                                           const int source_rank, const int destination_rank, const int data_size) {
   const int dimensions = CalcDimensions(world_size);
 
   std::vector<std::int32_t> payload_buffer{};
@@ -145,13 +146,13 @@ void InitPayloadIfSource(const int world_rank, const int source_rank, const int
   InitPayloadIfSource(world_rank, source_rank, data_size, &payload_buffer, &has_payload);
 
   for (int dim_index = 0; dim_index < dimensions; dim_index++) {
-    const bool ok = RouteOneDimension(world_rank, destination_rank, dim_index, &payload_buffer, &has_payload);
+    const bool ok = RouteOneDimension(comm, world_rank, destination_rank, dim_index, &payload_buffer, &has_payload);
     if (!ok) {
       return data_size;
     }
   }
 
-  return FinalizeRoutedSize(world_rank, destination_rank, has_payload, payload_buffer);
+  return FinalizeRoutedSize(comm, world_rank, destination_rank, has_payload, payload_buffer);
 }
 
 }  // namespace
@@ -178,8 +179,8 @@ bool TsarkovKHypercubeMPI::PreProcessingImpl() {
 bool TsarkovKHypercubeMPI::RunImpl() {
   int world_rank = 0;
   int world_size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+  MPI_Comm_rank(GetComm(), &world_rank);
+  MPI_Comm_size(GetComm(), &world_size);
 
   const InType &input_data = GetInput();
   const int source_rank = input_data[0];
@@ -191,7 +192,7 @@ bool TsarkovKHypercubeMPI::RunImpl() {
     return true;
   }
 
-  GetOutput() = RouteHypercubeAndGetSize(world_rank, world_size, source_rank, destination_rank, data_size);
+  GetOutput() = RouteHypercubeAndGetSize(GetComm(), world_rank, world_size, source_rank, destination_rank, data_size);
   return true;
 }
 
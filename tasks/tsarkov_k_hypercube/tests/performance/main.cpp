@@ -5,6 +5,7 @@
 #include "tsarkov_k_hypercube/mpi/include/ops_mpi.hpp"
 #include "tsarkov_k_hypercube/seq/include/ops_seq.hpp"
 #include "util/include/perf_test_util.hpp"
+#include "util/include/task_comm.hpp"
 
 namespace tsarkov_k_hypercube {
 
@@ -14,7 +15,7 @@ class TsarkovKHypercubePerfTests : public ppc::util::BaseRunPerfTests<InType, Ou
 
   void SetUp() override {
     int world_size = 0;
-    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+    MPI_Comm_size(ppc::util::GetTaskParentComm(), &world_size);
     input_data_.resize(3);
     input_data_[0] = 0;
     input_data_[1] = world_size - 1;
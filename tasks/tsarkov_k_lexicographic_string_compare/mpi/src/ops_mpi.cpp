@@ -6,9 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
-#include <string>
-#include <utility>
-#include <vector>
+#include <string_view>
 
 #include "tsarkov_k_lexicographic_string_compare/common/include/common.hpp"
 
@@ -16,42 +14,7 @@ namespace tsarkov_k_lexicographic_string_compare {
 
 namespace {
 
-std::vector<char> StringToBuffer(const std::string &s) {
-  return {s.begin(), s.end()};
-}
-
-std::string BufferToString(const std::vector<char> &buf) {
-  return {buf.begin(), buf.end()};
-}
-
-void BroadcastString(std::string *value, int root, MPI_Comm comm) {
-  int rank = 0;
-  MPI_Comm_rank(comm, &rank);
-
-  int size = 0;
-  if (rank == root) {
-    size = static_cast<int>(value->size());
-  }
-
-  MPI_Bcast(&size, 1, MPI_INT, root, comm);
-
-  std::vector<char> buf;
-  if (rank == root) {
-    buf = StringToBuffer(*value);
-  } else {
-    buf.resize(static_cast<std::size_t>(size));
-  }
-
-  if (size > 0) {
-    MPI_Bcast(buf.data(), size, MPI_CHAR, root, comm);
-  }
-
-  if (rank != root) {
-    *value = BufferToString(buf);
-  }
-}
-
-std::uint64_t FindFirstDiffLocal(const std::string &first_str, const std::string &second_str, std::size_t begin,
+std::uint64_t FindFirstDiffLocal(std::string_view first_str, std::string_view second_str, std::size_t begin,
                                  std::size_t end) {
   const std::size_t no_index = std::numeric_limits<std::size_t>::max();
   std::size_t first_diff_index = no_index;
@@ -69,7 +32,7 @@ std::uint64_t FindFirstDiffLocal(const std::string &first_str, const std::string
   return static_cast<std::uint64_t>(first_diff_index);
 }
 
-int CompareAtIndexOrByLength(const std::string &first_str, const std::string &second_str, std::uint64_t global_first) {
+int CompareAtIndexOrByLength(std::string_view first_str, std::string_view second_str, std::uint64_t global_first) {
   if (global_first == std::numeric_limits<std::uint64_t>::max()) {
     return (first_str.size() <= second_str.size()) ? 1 : 0;
   }
@@ -100,18 +63,11 @@ bool TsarkovKLexicographicStringCompareMPI::PreProcessingImpl() {
 bool TsarkovKLexicographicStringCompareMPI::RunImpl() {
   int process_rank = 0;
   int process_count = 1;
-  MPI_Comm_rank(MPI_COMM_WORLD, &process_rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &process_count);
-
-  std::string first_str;
-  std::string second_str;
-  if (process_rank == 0) {
-    first_str = GetInput().first;
-    second_str = GetInput().second;
-  }
+  MPI_Comm_rank(GetComm(), &process_rank);
+  MPI_Comm_size(GetComm(), &process_count);
 
-  BroadcastString(&first_str, 0, MPI_COMM_WORLD);
-  BroadcastString(&second_str, 0, MPI_COMM_WORLD);
+  const std::string_view first_str(GetInput().first);
+  const std::string_view second_str(GetInput().second);
 
   const std::size_t min_length = std::min(first_str.size(), second_str.size());
 
@@ -124,7 +80,7 @@ bool TsarkovKLexicographicStringCompareMPI::RunImpl() {
   const std::uint64_t local_first_diff = FindFirstDiffLocal(first_str, second_str, block_begin, block_end);
 
   std::uint64_t global_first_diff = std::numeric_limits<std::uint64_t>::max();
-  MPI_Allreduce(&local_first_diff, &global_first_diff, 1, MPI_UINT64_T, MPI_MIN, MPI_COMM_WORLD);
+  MPI_Allreduce(&local_first_diff, &global_first_diff, 1, MPI_UINT64_T, MPI_MIN, GetComm());
 
   const int result = CompareAtIndexOrByLength(first_str, second_str, global_first_diff);
 
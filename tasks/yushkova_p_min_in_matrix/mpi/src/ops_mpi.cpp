@@ -46,8 +46,8 @@ bool YushkovaPMinInMatrixMPI::RunImpl() {
   int n = static_cast<int>(GetInput());
   int world_size = 0;
   int rank = 0;
-  MPI_Comm_size(MPI_COMM_WORLD, &world_size);
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(GetComm(), &world_size);
+  MPI_Comm_rank(GetComm(), &rank);
 
   int base_rows = n / world_size;
   int extra = n % world_size;
@@ -78,7 +78,7 @@ bool YushkovaPMinInMatrixMPI::RunImpl() {
   }
 
   MPI_Allgatherv(local_results.data(), my_count, MPI_INT, GetOutput().data(), recv_counts.data(), offsets.data(),
-                 MPI_INT, MPI_COMM_WORLD);
+                 MPI_INT, GetComm());
 
   return true;
 }
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "performance/include/performance.hpp"
+#include "util/include/task_comm.hpp"
 #include "util/include/util.hpp"
 #include "yushkova_p_min_in_matrix/common/include/common.hpp"
 #include "yushkova_p_min_in_matrix/mpi/include/ops_mpi.hpp"
@@ -61,7 +62,7 @@ bool IsRootOrSingleProcess() {
   }
 
   int rank = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_rank(ppc::util::GetTaskParentComm(), &rank);
   return rank == 0;
 }
 
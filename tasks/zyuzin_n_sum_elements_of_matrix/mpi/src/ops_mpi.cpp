@@ -4,8 +4,10 @@
 
 #include <cstddef>
 #include <numeric>
+#include <span>
 #include <vector>
 
+#include "util/include/mpi_collectives.hpp"
 #include "zyuzin_n_sum_elements_of_matrix/common/include/common.hpp"
 
 namespace zyuzin_n_sum_elements_of_matrix {
@@ -31,32 +33,18 @@ bool ZyuzinNSumElementsOfMatrixMPI::RunImpl() {
   const auto &matrix = GetInput();
   int rank = 0;
   int size = 0;
-  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  MPI_Comm_rank(GetComm(), &rank);
+  MPI_Comm_size(GetComm(), &size);
 
-  int rows_per_proc = std::get<0>(matrix) / size;
-  int ost = std::get<0>(matrix) % size;
-
-  std::vector<int> send_counts(size, 0);
-  std::vector<int> start_indexs(size, 0);
-  int offset = 0;
-  for (int i = 0; i < size; ++i) {
-    int rows = rows_per_proc + (ost > 0 ? 1 : 0);
-    if (ost > 0) {
-      --ost;
-    }
-    send_counts[i] = rows * std::get<1>(matrix);
-    start_indexs[i] = offset;
-    offset += send_counts[i];
-  }
-
-  std::vector<double> local_data(send_counts[rank]);
-  MPI_Scatterv(std::get<2>(matrix).data(), send_counts.data(), start_indexs.data(), MPI_DOUBLE, local_data.data(),
-               send_counts[rank], MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  // Whole rows go to every rank, the first ones get one row more
+  const ppc::util::mpi::BlockPartition partition(static_cast<std::size_t>(std::get<0>(matrix)), size, 0,
+                                                 static_cast<std::size_t>(std::get<1>(matrix)));
+  const std::vector<double> local_data =
+      ppc::util::mpi::ScatterBalanced(std::span<const double>(std::get<2>(matrix)), partition, 0, GetComm());
 
   double local_sum = std::accumulate(local_data.begin(), local_data.end(), 0.0);
   double global_sum = 0.0;
-  MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  MPI_Allreduce(&local_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, GetComm());
 
   GetOutput() = global_sum;
   return true;